@@ -0,0 +1,91 @@
+// Потребитель забирает из очереди пачки по batch элементов: цикл front() + pop_front()
+// против drain_front() в тот же буфер; отдельно - удаление пачки без чтения (pop_front в цикле
+// против pop_front_n). Очередь каждый раз заново наполняется до total элементов, время -
+// только на разбор. Два типа: тривиальная 32-байтная задача и std::string.
+//
+//   g++ -O2 -std=c++17 bench/batch_drain.cpp -o batch_drain && ./batch_drain [total] [batch]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../my_deque.h"
+
+struct Task {
+    uint64_t id;
+    uint64_t deadline;
+    uint64_t payload;
+    uint32_t kind;
+    uint32_t priority;
+};
+
+static Task make(size_t i, Task*) {
+    return Task{i, i * 2, i * 3, uint32_t(i & 7), 0};
+}
+
+static std::string make(size_t i, std::string*) {
+    return "payload-" + std::to_string(i) + "-with-enough-text-to-allocate";
+}
+
+template <typename F>
+double measure(size_t elements, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / elements;
+}
+
+template <typename T>
+void run(const char* name, size_t total, size_t batch) {
+    Deque<T> queue;
+    std::vector<T> buffer(batch);
+    auto refill = [&] {
+        for (size_t i = 0; i < total; ++i) queue.push_back(make(i, static_cast<T*>(nullptr)));
+    };
+
+    refill();
+    double ns_loop = measure(total, [&] {
+        while (!queue.empty()) {
+            size_t n = 0;
+            for ( ; n < batch && !queue.empty(); ++n) {
+                buffer[n] = std::move(queue[0]);
+                queue.pop_front();
+            }
+        }
+    });
+
+    refill();
+    double ns_drain = measure(total, [&] {
+        while (!queue.empty()) {
+            queue.drain_front(buffer.begin(), batch);
+        }
+    });
+
+    refill();
+    double ns_pop = measure(total, [&] {
+        while (!queue.empty()) {
+            for (size_t n = 0; n < batch && !queue.empty(); ++n) queue.pop_front();
+        }
+    });
+
+    refill();
+    double ns_pop_n = measure(total, [&] {
+        while (!queue.empty()) {
+            queue.pop_front_n(batch);
+        }
+    });
+
+    std::printf("  %-12s move+pop_front %6.2f  drain_front %6.2f  pop_front loop %6.2f  pop_front_n %6.2f ns/elem\n",
+                name, ns_loop, ns_drain, ns_pop, ns_pop_n);
+}
+
+int main(int argc, char** argv) {
+    size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    std::printf("%zu elements in batches of %zu\n", total, batch);
+    run<Task>("Task", total, batch);
+    run<std::string>("std::string", total, batch);
+}
@@ -0,0 +1,53 @@
+// Сравнение геометрии бакетов: Deque<int, 16> (ближайшая степень двойки к старым 10 элементам)
+// против геометрии по умолчанию (~4 KiB на бакет) и std::deque.
+//
+//   g++ -O2 -std=c++17 bench/bucket_geometry.cpp -o bucket_geometry && ./bucket_geometry [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "../my_deque.h"
+
+template <typename Container>
+void run(const char* name, size_t n, const std::vector<size_t>& indices) {
+    Container deq;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        deq.push_back(static_cast<int>(i));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long sum = 0;
+    for (size_t index : indices) {
+        sum += deq[index];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    for (auto it = deq.begin(); it != deq.end(); ++it) {
+        sum += *it;
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    auto ns = [](auto a, auto b) { return std::chrono::duration<double, std::nano>(b - a).count(); };
+    std::printf("%-22s push_back %6.2f ns/op   random [] %6.2f ns/op   iterate %6.2f ns/op   (checksum %lld)\n",
+                name, ns(t0, t1) / n, ns(t1, t2) / indices.size(), ns(t2, t3) / n, sum);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<size_t> dist(0, n - 1);
+    std::vector<size_t> indices(n);
+    for (size_t& index : indices) {
+        index = dist(gen);
+    }
+
+    run<Deque<int, 16>>("Deque<int, 16>", n, indices);
+    run<Deque<int>>("Deque<int> (default)", n, indices);
+    run<std::deque<int>>("std::deque<int>", n, indices);
+}
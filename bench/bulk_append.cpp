@@ -0,0 +1,80 @@
+// Загрузка пачек записей в Deque: append_range/prepend_range против цикла push_back и чистого memcpy.
+//
+//   g++ -O2 -std=c++17 bench/bulk_append.cpp -o bulk_append && ./bulk_append [batch] [batches]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "../my_deque.h"
+
+struct Record {
+    long long id;
+    long long timestamp;
+    double    value;
+    int       flags;
+};
+
+template <typename F>
+double measure(size_t elements, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / elements;
+}
+
+int main(int argc, char** argv) {
+    size_t batch   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t batches = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+    size_t total   = batch * batches;
+
+    std::vector<Record> source(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        source[i] = Record{static_cast<long long>(i), static_cast<long long>(i) * 10, i * 0.5, static_cast<int>(i & 7)};
+    }
+
+    double ns_memcpy = measure(total, [&] {
+        std::vector<Record> dst(total);
+        for (size_t b = 0; b < batches; ++b) {
+            std::memcpy(dst.data() + b * batch, source.data(), batch * sizeof(Record));
+        }
+    });
+
+    double ns_push = measure(total, [&] {
+        Deque<Record> deq;
+        for (size_t b = 0; b < batches; ++b) {
+            for (const Record& r : source) deq.push_back(r);
+        }
+    });
+
+    double ns_append = measure(total, [&] {
+        Deque<Record> deq;
+        for (size_t b = 0; b < batches; ++b) {
+            deq.append_range(source);
+        }
+    });
+
+    double ns_prepend = measure(total, [&] {
+        Deque<Record> deq;
+        for (size_t b = 0; b < batches; ++b) {
+            deq.prepend_range(source);
+        }
+    });
+
+    double ns_std = measure(total, [&] {
+        std::deque<Record> deq;
+        for (size_t b = 0; b < batches; ++b) {
+            deq.insert(deq.end(), source.begin(), source.end());
+        }
+    });
+
+    std::printf("%zu batches x %zu records (%zu bytes each)\n", batches, batch, sizeof(Record));
+    std::printf("  memcpy into vector      %6.2f ns/elem\n", ns_memcpy);
+    std::printf("  Deque push_back loop    %6.2f ns/elem\n", ns_push);
+    std::printf("  Deque append_range      %6.2f ns/elem\n", ns_append);
+    std::printf("  Deque prepend_range     %6.2f ns/elem\n", ns_prepend);
+    std::printf("  std::deque insert(end)  %6.2f ns/elem\n", ns_std);
+}
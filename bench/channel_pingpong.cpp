@@ -0,0 +1,169 @@
+// Передача сообщений между корутинами через Channel против потоков на condition_variable
+// (BoundedDeque<bounded_block>: мьютекс + not_empty/not_full).
+//   - ping-pong: два участника перекидываются числом rounds раз, время - на одну передачу
+//     (половину круга); корутины на одном исполнителе, корутины на двух исполнителях в двух
+//     потоках и два потока на condition_variable;
+//   - pipeline: источник -> стадия (x * 2 + 1) -> сток через очереди емкостью 64, время - на элемент.
+// Файл собирается как C++20 (корутины), в отличие от остальных бенчмарков.
+//
+//   g++ -O2 -std=c++20 -pthread bench/channel_pingpong.cpp -o channel_pingpong && ./channel_pingpong [rounds] [items]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "../bounded_deque.h"
+#include "../deque_channel.h"
+
+template <typename F>
+double measure(size_t n, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / n;
+}
+
+using IntChannel = Channel<long>;
+using BlockingQueue = BoundedDeque<long, bounded_block>;
+
+static channel_task ping(IntChannel& to, IntChannel& from, size_t rounds, long& sum, channel_executor* stop) {
+    for (size_t i = 0; i < rounds; ++i) {
+        co_await to.push(long(i));
+        sum += *co_await from.pop();
+    }
+    to.close();
+    if (stop != nullptr) stop->stop();
+}
+
+static channel_task pong(IntChannel& from, IntChannel& to, channel_executor* stop) {
+    while (auto v = co_await from.pop()) {
+        co_await to.push(*v + 1);
+    }
+    if (stop != nullptr) stop->stop();
+}
+
+static channel_task source(IntChannel& out, size_t items) {
+    for (size_t i = 0; i < items; ++i) {
+        co_await out.push(long(i));
+    }
+    out.close();
+}
+
+static channel_task stage(IntChannel& in, IntChannel& out) {
+    while (auto v = co_await in.pop()) {
+        co_await out.push(*v * 2 + 1);
+    }
+    out.close();
+}
+
+static channel_task sink(IntChannel& in, long& sum) {
+    while (auto v = co_await in.pop()) {
+        sum += *v;
+    }
+}
+
+static void report(const char* name, double ns) {
+    std::printf("  %-32s %9.1f\n", name, ns);
+}
+
+static void check(const char* what, long sum, long expected) {
+    if (sum != expected) {
+        std::printf("%s: checksum mismatch\n", what);
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t items  = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+
+    long ping_expected = long(rounds) * long(rounds + 1) / 2;
+    std::printf("ping-pong, %zu rounds, ns per hand-off\n", rounds);
+    {
+        channel_executor executor;
+        IntChannel a(1), b(1);
+        long sum = 0;
+        double ns = measure(2 * rounds, [&] {
+            executor.spawn(ping(a, b, rounds, sum, nullptr));
+            executor.spawn(pong(a, b, nullptr));
+            executor.run_ready();
+        });
+        check("coroutines", sum, ping_expected);
+        report("coroutines, one executor", ns);
+    }
+    {
+        channel_executor left, right;
+        IntChannel a(1), b(1);
+        long sum = 0;
+        double ns = measure(2 * rounds, [&] {
+            left.spawn(ping(a, b, rounds, sum, &left));
+            right.spawn(pong(a, b, &right));
+            std::thread other([&] { right.run(); });
+            left.run();
+            other.join();
+        });
+        check("executors", sum, ping_expected);
+        report("coroutines, executor per thread", ns);
+    }
+    {
+        BlockingQueue a(1), b(1);
+        long sum = 0;
+        double ns = measure(2 * rounds, [&] {
+            std::thread other([&] {
+                long v;
+                for (size_t i = 0; i < rounds; ++i) {
+                    a.wait_pop_front(v);
+                    b.push_back(v + 1);
+                }
+            });
+            long v;
+            for (size_t i = 0; i < rounds; ++i) {
+                a.push_back(long(i));
+                b.wait_pop_front(v);
+                sum += v;
+            }
+            other.join();
+        });
+        check("condition_variable", sum, ping_expected);
+        report("threads, condition_variable", ns);
+    }
+
+    long pipe_expected = long(items) * long(items);  // сумма 2i + 1 по i < items
+    std::printf("pipeline source -> stage -> sink, %zu items, capacity 64, ns per item\n", items);
+    {
+        channel_executor executor;
+        IntChannel first(64), second(64);
+        long sum = 0;
+        double ns = measure(items, [&] {
+            executor.spawn(sink(second, sum));
+            executor.spawn(stage(first, second));
+            executor.spawn(source(first, items));
+            executor.run_ready();
+        });
+        check("pipeline coroutines", sum, pipe_expected);
+        report("coroutines, one executor", ns);
+    }
+    {
+        BlockingQueue first(64), second(64);
+        long sum = 0;
+        double ns = measure(items, [&] {
+            // -1 - конец потока
+            std::thread producer([&] {
+                for (size_t i = 0; i < items; ++i) first.push_back(long(i));
+                first.push_back(-1);
+            });
+            std::thread middle([&] {
+                long v;
+                for (first.wait_pop_front(v); v >= 0; first.wait_pop_front(v)) second.push_back(v * 2 + 1);
+                second.push_back(-1);
+            });
+            long v;
+            for (second.wait_pop_front(v); v >= 0; second.wait_pop_front(v)) sum += v;
+            producer.join();
+            middle.join();
+        });
+        check("pipeline threads", sum, pipe_expected);
+        report("threads, condition_variable", ns);
+    }
+}
@@ -0,0 +1,98 @@
+// Память и скорость CompressedDeque<uint64_t> против Deque<uint64_t> на трех рядах по n значений:
+// подряд идущие id, метки времени с шагом 1-3 мкс (в наносекундах) и случайные числа (не сжимаются).
+// Меряются push_back, последовательный проход (for_each_segment у CompressedDeque, итераторы у Deque),
+// случайный operator[] и разбор с головы pop_front; память - по memory_usage() обоих.
+//
+//   g++ -O2 -std=c++17 bench/compressed_timestamps.cpp -o compressed_timestamps && ./compressed_timestamps [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../compressed_deque.h"
+
+template <typename F>
+double measure(size_t n, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / n;
+}
+
+struct Result {
+    size_t bytes;
+    double push, scan, random, pop;
+};
+
+template <typename Container, typename Next, typename Scan>
+Result run(size_t n, Next next, Scan scan, const std::vector<size_t>& indices, uint64_t expected) {
+    Result r;
+    Container deq;
+    r.push = measure(n, [&] {
+        for (size_t i = 0; i < n; ++i) deq.push_back(next(i));
+    });
+    r.bytes = deq.memory_usage().total_bytes();
+
+    uint64_t sum = 0;
+    r.scan = measure(n, [&] { sum = scan(deq); });
+    if (sum != expected) {
+        std::printf("checksum mismatch\n");
+        std::exit(1);
+    }
+
+    volatile uint64_t sink = 0;
+    r.random = measure(indices.size(), [&] {
+        uint64_t s = 0;
+        for (size_t index : indices) s += deq[index];
+        sink = s;
+    });
+
+    r.pop = measure(n, [&] {
+        while (!deq.empty()) deq.pop_front();
+    });
+    return r;
+}
+
+template <typename Next>
+void series(const char* name, size_t n, Next next, const std::vector<size_t>& indices) {
+    uint64_t expected = 0;
+    for (size_t i = 0; i < n; ++i) expected += next(i);
+
+    Result plain = run<Deque<uint64_t>>(n, next, [](const Deque<uint64_t>& d) {
+        return std::accumulate(d.begin(), d.end(), uint64_t(0));
+    }, indices, expected);
+    Result packed = run<CompressedDeque<uint64_t>>(n, next, [](const CompressedDeque<uint64_t>& d) {
+        uint64_t s = 0;
+        d.for_each_segment([&s](const uint64_t* first, const uint64_t* last) { s = std::accumulate(first, last, s); });
+        return s;
+    }, indices, expected);
+
+    std::printf("%s\n", name);
+    std::printf("  %-16s %8.1f MiB  push %5.2f  scan %5.2f  random %6.1f  pop_front %5.2f ns\n", "Deque",
+                plain.bytes / 1048576.0, plain.push, plain.scan, plain.random, plain.pop);
+    std::printf("  %-16s %8.1f MiB  push %5.2f  scan %5.2f  random %6.1f  pop_front %5.2f ns   %.1fx smaller\n", "CompressedDeque",
+                packed.bytes / 1048576.0, packed.push, packed.scan, packed.random, packed.pop, double(plain.bytes) / packed.bytes);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+
+    std::mt19937_64 rng(7);
+    std::vector<size_t> indices(2000000);
+    for (size_t& index : indices) index = rng() % n;
+
+    // ряды детерминированы по i, чтобы оба контейнера получили одно и то же
+    std::vector<uint32_t> steps(n);
+    for (uint32_t& step : steps) step = 1000 + uint32_t(rng() % 2000);
+    std::vector<uint64_t> stamps(n);
+    for (size_t i = 0, t = 1700000000000000000ull; i < n; ++i) stamps[i] = t += steps[i];
+    std::vector<uint32_t>().swap(steps);
+
+    std::printf("%zu uint64_t per series\n", n);
+    series("sequential ids", n, [](size_t i) { return uint64_t(1000000 + i); }, indices);
+    series("timestamps, 1-3 us apart", n, [&](size_t i) { return stamps[i]; }, indices);
+    series("random (incompressible)", n, [&](size_t i) { return stamps[i] * 0x9E3779B97F4A7C15ull; }, indices);
+}
@@ -0,0 +1,405 @@
+// Общий бенчмарк Deque против std::deque и std::vector.
+// Операции: push_back, push_front, pop с обоих концов, FIFO-окно, случайный operator[],
+// последовательный обход, std::sort через итераторы, вставка/удаление в середине,
+// копирование, move-присваивание.
+// Типы элементов: int, 64-байтный POD, std::string (вне SSO), move-only тип.
+// Для каждой комбинации печатает ns/op, выделения памяти на операцию и пиковый прирост RSS.
+// Каждый случай выполняется в отдельном процессе (fork), чтобы пик RSS не смешивался.
+// boost::container::deque/devector в окружении нет, поэтому в сравнении только std.
+//
+//   g++ -O2 -std=c++17 bench/deque_bench.cpp -o deque_bench && ./deque_bench [max_n] [case]
+//
+// max_n - наибольший размер (по умолчанию 10^6, размеры идут степенями 10 от 10), до 10^8;
+// case - запустить только операции, в названии которых есть эта подстрока.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../my_deque.h"
+
+
+// Подсчет выделений ----------------------------------------------------------------------------/
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+
+// RSS процесса ---------------------------------------------------------------------------------/
+static size_t read_status_kib(const char* key) {
+    FILE* f = std::fopen("/proc/self/status", "r");
+    if (!f) return 0;
+    char line[256];
+    size_t value = 0;
+    size_t key_len = std::strlen(key);
+    while (std::fgets(line, sizeof(line), f)) {
+        if (std::strncmp(line, key, key_len) == 0) {
+            value = std::strtoull(line + key_len, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(f);
+    return value;
+}
+
+// сбрасывает VmHWM до текущего RSS (Linux 4.0+)
+static void reset_peak_rss() {
+    if (FILE* f = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", f);
+        std::fclose(f);
+    }
+}
+
+
+// Типы элементов -------------------------------------------------------------------------------/
+struct Pod64 {
+    int64_t data[8];
+};
+
+struct MoveOnly {
+    int64_t value;
+
+    explicit MoveOnly(int64_t value = 0) : value(value) {}
+    MoveOnly(const MoveOnly&) = delete;
+    MoveOnly& operator=(const MoveOnly&) = delete;
+    MoveOnly(MoveOnly&& other) noexcept : value(other.value) { other.value = 0; }
+    MoveOnly& operator=(MoveOnly&& other) noexcept { value = other.value; other.value = 0; return *this; }
+};
+
+template <typename T> T make(size_t i);
+template <> int make<int>(size_t i) { return int(i); }
+template <> Pod64 make<Pod64>(size_t i) { Pod64 p{}; p.data[0] = int64_t(i); return p; }
+template <> std::string make<std::string>(size_t i) { return "element-with-a-long-name-" + std::to_string(i); }
+template <> MoveOnly make<MoveOnly>(size_t i) { return MoveOnly(int64_t(i)); }
+
+static size_t weight(int x) { return size_t(x); }
+static size_t weight(const Pod64& p) { return size_t(p.data[0]); }
+static size_t weight(const std::string& s) { return s.size(); }
+static size_t weight(const MoveOnly& m) { return size_t(m.value); }
+
+struct less_key {
+    bool operator()(int a, int b) const { return a < b; }
+    bool operator()(const Pod64& a, const Pod64& b) const { return a.data[0] < b.data[0]; }
+    bool operator()(const std::string& a, const std::string& b) const { return a < b; }
+    bool operator()(const MoveOnly& a, const MoveOnly& b) const { return a.value < b.value; }
+};
+
+
+// Адаптеры контейнеров -------------------------------------------------------------------------/
+template <typename C> struct has_front_ops : std::true_type {};
+template <typename T, typename A> struct has_front_ops<std::vector<T, A>> : std::false_type {};
+
+template <typename C>
+void fill(C& c, size_t n) {
+    for (size_t i = 0; i < n; ++i) c.push_back(make<typename C::value_type>(i));
+}
+
+static volatile size_t sink;
+
+struct Measurement {
+    double ns = 0;
+    size_t ops = 0;
+    size_t allocations = 0;
+    bool skipped = false;
+};
+
+template <typename F>
+void timed(Measurement& m, size_t ops, F&& body) {
+    size_t allocs = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    m.allocations += allocation_count - allocs;
+    m.ns += std::chrono::duration<double, std::nano>(stop - start).count();
+    m.ops += ops;
+}
+
+// сколько раз повторить случай, чтобы набрать ~10^6 операций на малых размерах
+static size_t repeats_for(size_t ops_per_run) {
+    return std::max<size_t>(1, 1000000 / std::max<size_t>(1, ops_per_run));
+}
+
+
+// Случаи ---------------------------------------------------------------------------------------/
+template <typename C>
+Measurement case_push_back(size_t n) {
+    Measurement m;
+    for (size_t r = repeats_for(n); r > 0; --r) {
+        C c;
+        timed(m, n, [&] { fill(c, n); });
+    }
+    return m;
+}
+
+template <typename C>
+Measurement case_push_front(size_t n) {
+    Measurement m;
+    if constexpr (!has_front_ops<C>::value) {
+        m.skipped = true;
+    } else {
+        for (size_t r = repeats_for(n); r > 0; --r) {
+            C c;
+            timed(m, n, [&] {
+                for (size_t i = 0; i < n; ++i) c.push_front(make<typename C::value_type>(i));
+            });
+        }
+    }
+    return m;
+}
+
+template <typename C>
+Measurement case_pop_both(size_t n) {
+    Measurement m;
+    if constexpr (!has_front_ops<C>::value) {
+        m.skipped = true;
+    } else {
+        for (size_t r = repeats_for(n); r > 0; --r) {
+            C c;
+            fill(c, n);
+            timed(m, n, [&] {
+                for (size_t i = 0; i < n; ++i) {
+                    if (i & 1) c.pop_front(); else c.pop_back();
+                }
+            });
+        }
+    }
+    return m;
+}
+
+// окно из n элементов: push_back + pop_front, одна пара - одна операция
+template <typename C>
+Measurement case_fifo(size_t n) {
+    Measurement m;
+    if constexpr (!has_front_ops<C>::value) {
+        m.skipped = true;
+    } else {
+        C c;
+        fill(c, n);
+        size_t ops = std::max<size_t>(n, 1000000);
+        timed(m, ops, [&] {
+            for (size_t i = 0; i < ops; ++i) {
+                c.push_back(make<typename C::value_type>(i));
+                c.pop_front();
+            }
+        });
+    }
+    return m;
+}
+
+template <typename C>
+Measurement case_random_index(size_t n) {
+    Measurement m;
+    C c;
+    fill(c, n);
+    size_t ops = 1000000;
+    // индексы считаются на лету, чтобы их массив не попадал в пик RSS
+    std::minstd_rand rng(42);
+    timed(m, ops, [&] {
+        size_t acc = 0;
+        for (size_t i = 0; i < ops; ++i) acc += weight(c[rng() % n]);
+        sink = acc;
+    });
+    return m;
+}
+
+template <typename C>
+Measurement case_iterate(size_t n) {
+    Measurement m;
+    C c;
+    fill(c, n);
+    for (size_t r = repeats_for(n); r > 0; --r) {
+        timed(m, n, [&] {
+            size_t acc = 0;
+            for (const auto& x : c) acc += weight(x);
+            sink = acc;
+        });
+    }
+    return m;
+}
+
+// std::sort перемешанного контейнера: нагрузка на ++/--/сравнение/разность итераторов, ns на элемент
+template <typename C>
+Measurement case_sort(size_t n) {
+    Measurement m;
+    C c;
+    fill(c, n);
+    std::minstd_rand rng(42);
+    for (size_t r = repeats_for(n); r > 0; --r) {
+        std::shuffle(c.begin(), c.end(), rng);
+        timed(m, n, [&] { std::sort(c.begin(), c.end(), less_key()); });
+    }
+    sink = weight(c[0]);
+    return m;
+}
+
+// k вставок и k удалений около середины; на больших n это O(n) на операцию
+template <typename C>
+Measurement case_middle(size_t n) {
+    Measurement m;
+    C c;
+    fill(c, n);
+    size_t k = std::min<size_t>(n, n > 1000000 ? 100 : 1000);
+    timed(m, 2 * k, [&] {
+        for (size_t i = 0; i < k; ++i) c.insert(c.begin() + c.size() / 2, make<typename C::value_type>(i));
+        for (size_t i = 0; i < k; ++i) c.erase(c.begin() + c.size() / 2);
+    });
+    return m;
+}
+
+// копия целиком, ns и выделения на элемент
+template <typename C>
+Measurement case_copy(size_t n) {
+    Measurement m;
+    if constexpr (!std::is_copy_constructible<typename C::value_type>::value) {
+        m.skipped = true;
+    } else {
+        C c;
+        fill(c, n);
+        for (size_t r = repeats_for(n); r > 0; --r) {
+            timed(m, n, [&] {
+                C copy(c);
+                sink = copy.size();
+            });
+        }
+    }
+    return m;
+}
+
+// move-присваивание целого контейнера, ns на присваивание
+template <typename C>
+Measurement case_move_assign(size_t n) {
+    Measurement m;
+    C a, b;
+    fill(a, n);
+    size_t ops = 1000;
+    timed(m, ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            if (i & 1) a = std::move(b); else b = std::move(a);
+        }
+    });
+    sink = a.size() + b.size();
+    return m;
+}
+
+
+// Запуск ---------------------------------------------------------------------------------------/
+struct Report {
+    Measurement m;
+    size_t peak_kib;
+};
+
+// выполняет случай в дочернем процессе и возвращает замеры через pipe
+template <typename F>
+bool run_isolated(F&& body, Report& report) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    std::fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        reset_peak_rss();
+        size_t base_kib = read_status_kib("VmRSS:");
+        Report r;
+        r.m = body();
+        size_t peak = read_status_kib("VmHWM:");
+        r.peak_kib = peak > base_kib ? peak - base_kib : 0;
+        ssize_t written = write(fds[1], &r, sizeof(r));
+        _exit(written == ssize_t(sizeof(r)) ? 0 : 1);
+    }
+    close(fds[1]);
+    bool ok = pid > 0 && read(fds[0], &report, sizeof(report)) == ssize_t(sizeof(report));
+    close(fds[0]);
+    int status = 0;
+    if (pid > 0) waitpid(pid, &status, 0);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_row(const char* type, size_t n, const char* op, const char* container, const Report& r, bool ok) {
+    std::printf("%-12s %10zu  %-13s %-12s", type, n, op, container);
+    if (!ok) {
+        std::printf("  failed\n");
+    } else if (r.m.skipped) {
+        std::printf("  %10s\n", "-");
+    } else {
+        std::printf("  %10.2f ns/op  %8.4f alloc/op  %10.1f MiB peak\n",
+                    r.m.ns / r.m.ops, double(r.m.allocations) / r.m.ops, r.peak_kib / 1024.0);
+    }
+}
+
+template <typename T, template <typename> class Case>
+void run_case(const char* type, size_t n, const char* op, const char* filter) {
+    if (filter && !std::strstr(op, filter)) return;
+
+    Report r{};
+    bool ok = run_isolated([n] { return Case<Deque<T>>::run(n); }, r);
+    print_row(type, n, op, "Deque", r, ok);
+    ok = run_isolated([n] { return Case<std::deque<T>>::run(n); }, r);
+    print_row(type, n, op, "std::deque", r, ok);
+    ok = run_isolated([n] { return Case<std::vector<T>>::run(n); }, r);
+    print_row(type, n, op, "std::vector", r, ok);
+}
+
+#define BENCH_CASE(name) \
+    template <typename C> struct name##_t { static Measurement run(size_t n) { return case_##name<C>(n); } }
+
+BENCH_CASE(push_back);
+BENCH_CASE(push_front);
+BENCH_CASE(pop_both);
+BENCH_CASE(fifo);
+BENCH_CASE(random_index);
+BENCH_CASE(iterate);
+BENCH_CASE(sort);
+BENCH_CASE(middle);
+BENCH_CASE(copy);
+BENCH_CASE(move_assign);
+
+template <typename T>
+void run_type(const char* type, size_t max_n, const char* filter) {
+    for (size_t n = 10; n <= max_n; n *= 10) {
+        run_case<T, push_back_t>(type, n, "push_back", filter);
+        run_case<T, push_front_t>(type, n, "push_front", filter);
+        run_case<T, pop_both_t>(type, n, "pop_both", filter);
+        run_case<T, fifo_t>(type, n, "fifo", filter);
+        run_case<T, random_index_t>(type, n, "random_index", filter);
+        run_case<T, iterate_t>(type, n, "iterate", filter);
+        run_case<T, sort_t>(type, n, "sort", filter);
+        run_case<T, middle_t>(type, n, "middle", filter);
+        run_case<T, copy_t>(type, n, "copy", filter);
+        run_case<T, move_assign_t>(type, n, "move_assign", filter);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const char* filter = argc > 2 ? argv[2] : nullptr;
+
+    std::printf("%-12s %10s  %-13s %-12s  %16s  %16s  %19s\n", "type", "n", "op", "container", "time", "allocations", "RSS");
+
+    run_type<int>("int", max_n, filter);
+    run_type<Pod64>("Pod64", max_n, filter);
+    run_type<std::string>("std::string", max_n, filter);
+    run_type<MoveOnly>("MoveOnly", max_n, filter);
+}
@@ -0,0 +1,71 @@
+// Счетчик аллокаций для FIFO-нагрузки push_back/pop_front: после прогрева
+// бакеты должны браться только из пула пустых бакетов Deque, а карта не должна расти.
+// Это проверка, а не только замер: первый раунд - прогрев, и если в любом следующем раунде
+// были аллокации бакетов или карты, программа печатает FAIL и возвращает 1.
+//
+//   g++ -O2 -std=c++17 bench/fifo_allocations.cpp -o fifo_allocations && ./fifo_allocations
+
+#include <cstdio>
+#include <memory>
+#include <type_traits>
+
+#include "../my_deque.h"
+
+static size_t bucket_allocations = 0; // allocate() для элементов
+static size_t map_allocations    = 0; // allocate() для карты и пула (rebind к T*)
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++(std::is_pointer<T>::value ? map_allocations : bucket_allocations);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+int main() {
+    constexpr size_t window = 10000;
+    constexpr size_t rounds = 10;
+    constexpr size_t ops    = 1000000;
+
+    Deque<int, deque_detail::default_bucket_size<int>(), CountingAllocator<int>> deq;
+    for (size_t i = 0; i < window; ++i) {
+        deq.push_back(static_cast<int>(i));
+    }
+
+    bool steady = true;
+    for (size_t round = 0; round < rounds; ++round) {
+        size_t buckets_before = bucket_allocations;
+        size_t map_before     = map_allocations;
+        for (size_t i = 0; i < ops; ++i) {
+            deq.push_back(static_cast<int>(i));
+            deq.pop_front();
+        }
+        std::printf("round %zu: %zu bucket allocations, %zu map allocations per %zu push/pop pairs\n",
+                    round, bucket_allocations - buckets_before, map_allocations - map_before, ops);
+        if (round > 0 && (bucket_allocations != buckets_before || map_allocations != map_before)) {
+            steady = false;
+        }
+    }
+
+    if (!steady) {
+        std::printf("FAIL: heap allocations after warm-up\n");
+        return 1;
+    }
+    std::printf("ok: no heap allocations after warm-up\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Обход большого Deque<uint64_t> (по умолчанию 1 GiB) с разными аллокаторами бакетов:
+// std::allocator, deque_aligned_allocator<.., 4096> (бакет - ровно одна страница) и
+// deque_huge_page_allocator (бакеты на transparent huge pages). Меряются последовательный проход
+// итераторами и случайный доступ operator[]; для huge pages печатается, сколько памяти процесса
+// ядро действительно отдало страницами по 2 MiB (AnonHugePages из /proc/self/smaps_rollup).
+//
+// Перед замерами проверяется, что дек после перемещения из него остается рабочим (иначе код возврата 1).
+//
+//   g++ -O2 -std=c++17 bench/huge_page_scan.cpp -o huge_page_scan && ./huge_page_scan [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../deque_aligned.h"
+
+template <typename F>
+double measure(size_t n, int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(n) * repeats);
+}
+
+static long anon_huge_pages_kib() {
+    FILE* f = std::fopen("/proc/self/smaps_rollup", "r");
+    if (f == nullptr) return -1;
+    char line[256];
+    long kib = -1;
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        if (std::strncmp(line, "AnonHugePages:", 14) == 0) {
+            kib = std::strtol(line + 14, nullptr, 10);
+        }
+    }
+    std::fclose(f);
+    return kib;
+}
+
+template <typename Container>
+void run(const char* name, size_t n, const std::vector<size_t>& indices) {
+    Container deq;
+    for (size_t i = 0; i < n; ++i) {
+        deq.push_back(i);
+    }
+
+    volatile uint64_t sink = 0;
+    double ns_scan = measure(n, 3, [&] { sink = std::accumulate(deq.begin(), deq.end(), uint64_t(0)); });
+    double ns_random = measure(indices.size(), 1, [&] {
+        uint64_t sum = 0;
+        for (size_t index : indices) sum += deq[index];
+        sink = sum;
+    });
+
+    std::printf("  %-22s scan %6.3f ns/elem  random %6.2f ns/access  AnonHugePages %ld MiB\n",
+                name, ns_scan, ns_random, anon_huge_pages_kib() / 1024);
+}
+
+// Дек, из которого переместили, должен остаться рабочим: аллокатор после перемещения - все та же арена
+static void check_moved_from_reuse() {
+    huge_pages::Deque<int> a;
+    for (int i = 0; i < 100; ++i) a.push_back(i);
+    huge_pages::Deque<int> b(std::move(a));
+    a.push_back(1);
+    huge_pages::Deque<int> c;
+    c = std::move(b);
+    b.push_back(2);
+    b = std::move(a);
+    if (b.size() != 1 || b[0] != 1 || c.size() != 100 || c[99] != 99) {
+        std::printf("moved-from huge_pages::Deque is broken\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    check_moved_from_reuse();
+
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 27;
+
+    std::mt19937_64 rng(42);
+    std::vector<size_t> indices(10000000);
+    for (size_t& index : indices) index = rng() % n;
+
+    std::printf("%zu uint64_t (%zu MiB)\n", n, n * sizeof(uint64_t) >> 20);
+    run<Deque<uint64_t>>("std::allocator", n, indices);
+    run<Deque<uint64_t, 512, deque_aligned_allocator<uint64_t, 4096>>>("aligned to 4096", n, indices);
+    run<huge_pages::Deque<uint64_t>>("huge pages", n, indices);
+}
@@ -0,0 +1,97 @@
+// Очередь под нагрузкой многих потоков: MpmcQueue против Deque под std::mutex.
+// Каждый из t потоков (1, 2, 4, ... max_threads) делает ops / t пар push + pop, так что
+// все потоки одновременно и производители, и потребители, и очередь не бывает пустой надолго.
+// Сумма забранных значений сверяется с суммой положенных - это же и стресс-тест;
+// для проверки гонок собирать с -fsanitize=thread и маленьким ops.
+//
+// На машине с числом ядер меньше t потоки вытесняют друг друга, и это тоже часть картины:
+// ожидающий в MpmcQueue после короткого спина уступает процессор.
+//
+//   g++ -O2 -std=c++17 -pthread bench/mpmc_contention.cpp -o mpmc_contention && ./mpmc_contention [ops] [max_threads]
+//   g++ -O1 -g -std=c++17 -fsanitize=thread bench/mpmc_contention.cpp -o mpmc_tsan && ./mpmc_tsan 100000 8
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../mpmc_queue.h"
+
+// Deque под мьютексом с тем же интерфейсом, что у MpmcQueue
+struct LockedDeque {
+    std::mutex mutex;
+    Deque<uint64_t> deq;
+
+    explicit LockedDeque(size_t) {}
+
+    void push(uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deq.push_back(value);
+    }
+
+    void pop(uint64_t& out) {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!deq.empty()) {
+                    out = deq[0];
+                    deq.pop_front();
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+};
+
+template <typename Queue>
+double run(size_t threads, size_t ops) {
+    Queue q(1024);
+    size_t per_thread = ops / threads;
+    std::atomic<uint64_t> popped_sum{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            uint64_t sum = 0;
+            uint64_t value;
+            for (size_t i = 0; i < per_thread; ++i) {
+                q.push(t * per_thread + i);
+                q.pop(value);
+                sum += value;
+            }
+            popped_sum.fetch_add(sum);
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    auto stop = std::chrono::steady_clock::now();
+
+    uint64_t n = threads * per_thread;
+    if (popped_sum.load() != n * (n - 1) / 2) {
+        std::printf("checksum mismatch with %zu threads\n", threads);
+        std::exit(1);
+    }
+    // push и pop - две операции
+    return 2.0 * n / std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t ops         = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+
+    std::printf("%zu push+pop pairs, %u hardware threads, Mops/s\n", ops, std::thread::hardware_concurrency());
+    std::printf("  threads    MpmcQueue  mutex+Deque\n");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double mpmc   = run<MpmcQueue<uint64_t>>(threads, ops);
+        double locked = run<LockedDeque>(threads, ops);
+        std::printf("  %7zu  %11.2f  %11.2f\n", threads, mpmc, locked);
+    }
+}
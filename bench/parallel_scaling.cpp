@@ -0,0 +1,86 @@
+// Масштабирование параллельных алгоритмов (deque_parallel.h) по числу потоков:
+// for_each, transform в std::vector, reduce, copy и sort на Deque<uint64_t>.
+// Потоки: 1, 2, 4, ... до числа ядер (и само число ядер); пул на 1 поток выполняет
+// все в вызывающем потоке, его время - база для ускорения.
+//
+//   g++ -O2 -std=c++17 -pthread bench/parallel_scaling.cpp -o parallel_scaling && ./parallel_scaling [n] [max_threads]
+//
+// n - число элементов, по умолчанию 10^8 (800 MB в деке плюс столько же под результат copy/transform);
+// max_threads - верхняя граница числа потоков, по умолчанию число ядер.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "../deque_parallel.h"
+
+static volatile uint64_t sink;
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// заполняет дек псевдослучайными значениями, одинаковыми для всех прогонов
+static void refill(DequeThreadPool& pool, Deque<uint64_t>& deq) {
+    size_t i = 0;
+    deq.for_each_segment([&i](uint64_t* first, uint64_t* last) {
+        for ( ; first != last; ++first) *first = i++;
+    });
+    transform(pool, deq, [](uint64_t x) { return mix(x + 1); });
+}
+
+template <typename F>
+double measure(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    size_t cores = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < cores; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores);
+
+    Deque<uint64_t> deq;
+    deq.reserve(n);
+    for (size_t i = 0; i < n; ++i) deq.push_back(0);
+    std::vector<uint64_t> out(n);
+
+    const char* names[] = {"for_each", "transform", "reduce", "copy", "sort"};
+    std::vector<std::vector<double>> times(5);
+
+    std::printf("n = %zu, cores = %zu\n", n, cores);
+    std::printf("%-8s %12s %12s %12s %12s %12s\n", "threads", names[0], names[1], names[2], names[3], names[4]);
+    for (size_t threads : thread_counts) {
+        DequeThreadPool pool(threads);
+        refill(pool, deq);
+
+        times[0].push_back(measure([&] { for_each(pool, deq, [](uint64_t& x) { x = x * 2 + 1; }); }));
+        times[1].push_back(measure([&] { transform(pool, deq, out.begin(), [](uint64_t x) { return mix(x); }); }));
+        times[2].push_back(measure([&] { sink = reduce(pool, deq, uint64_t(0)); }));
+        times[3].push_back(measure([&] { copy(pool, deq, out.begin()); }));
+        times[4].push_back(measure([&] { sort(pool, deq); }));
+        sink = out[n / 2] + deq[n / 2];
+
+        std::printf("%-8zu", threads);
+        for (size_t k = 0; k < 5; ++k) std::printf(" %9.1f ms", times[k].back());
+        std::printf("\n");
+    }
+
+    std::printf("\nspeedup vs 1 thread\n");
+    for (size_t i = 0; i < thread_counts.size(); ++i) {
+        std::printf("%-8zu", thread_counts[i]);
+        for (size_t k = 0; k < 5; ++k) std::printf(" %11.2fx", times[k][0] / times[k][i]);
+        std::printf("\n");
+    }
+    return 0;
+}
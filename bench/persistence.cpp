@@ -0,0 +1,99 @@
+// Сохранение и загрузка Deque<Record> (64 байта): поэлементные fwrite/fread + push_back
+// против save()/load() (бакет целиком за один вызов) и load_mapped() (бакеты прямо в
+// отображении файла). Для load_mapped() отдельно меряется первый проход по всем элементам -
+// на нем и происходят чтения страниц. Файлы пишутся в /tmp (или в dir) и остаются в page cache,
+// так что это пропускная способность без учета диска.
+//
+//   g++ -O2 -std=c++17 bench/persistence.cpp -o persistence && ./persistence [megabytes] [dir]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../deque_mmap.h"
+
+struct Record {
+    uint64_t id;
+    uint64_t timestamp;
+    double   values[6];
+};
+
+using clock_type = std::chrono::steady_clock;
+
+static double seconds_since(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+static void report(const char* name, double seconds, size_t bytes) {
+    std::printf("  %-24s %8.1f ms  %8.0f MB/s\n", name, seconds * 1e3, bytes / seconds / (1 << 20));
+}
+
+template <typename D>
+static uint64_t checksum(const D& deq) {
+    uint64_t sum = 0;
+    for (const Record& r : deq) sum += r.id ^ r.timestamp;
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512;
+    std::string dir  = argc > 2 ? argv[2] : "/tmp";
+    size_t n         = (megabytes << 20) / sizeof(Record);
+    size_t bytes     = n * sizeof(Record);
+    std::string naive_path = dir + "/deque_naive.bin";
+    std::string path       = dir + "/deque_save.bin";
+
+    mapped::Deque<Record> deq;
+    for (size_t i = 0; i < n; ++i) {
+        deq.push_back(Record{i, i * 3, {double(i), 1, 2, 3, 4, 5}});
+    }
+    uint64_t expected = checksum(deq);
+    std::printf("%zu records, %zu MB\n", n, bytes >> 20);
+
+    auto start = clock_type::now();
+    {
+        std::FILE* file = std::fopen(naive_path.c_str(), "wb");
+        for (const Record& r : deq) std::fwrite(&r, sizeof(r), 1, file);
+        std::fclose(file);
+    }
+    report("fwrite per element", seconds_since(start), bytes);
+
+    start = clock_type::now();
+    deq.save(path);
+    report("save()", seconds_since(start), bytes);
+    deq.clear();
+    deq.shrink_to_fit();
+
+    start = clock_type::now();
+    {
+        Deque<Record> loaded;
+        std::FILE* file = std::fopen(naive_path.c_str(), "rb");
+        Record r;
+        while (std::fread(&r, sizeof(r), 1, file) == 1) loaded.push_back(r);
+        std::fclose(file);
+        report("fread + push_back", seconds_since(start), bytes);
+        if (checksum(loaded) != expected) return 1;
+    }
+
+    start = clock_type::now();
+    {
+        Deque<Record> loaded = Deque<Record>::load(path);
+        report("load()", seconds_since(start), bytes);
+        if (checksum(loaded) != expected) return 1;
+    }
+
+    start = clock_type::now();
+    {
+        mapped::Deque<Record> loaded = mapped::Deque<Record>::load_mapped(path);
+        report("load_mapped()", seconds_since(start), bytes);
+        start = clock_type::now();
+        uint64_t sum = checksum(loaded);
+        report("load_mapped() first pass", seconds_since(start), bytes);
+        if (sum != expected) return 1;
+    }
+
+    std::remove(naive_path.c_str());
+    std::remove(path.c_str());
+    return 0;
+}
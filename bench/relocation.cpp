@@ -0,0 +1,89 @@
+// Побайтный перенос: копирование Deque<uint64_t> кусками бакетов против std::deque и
+// memcpy того же объема, и вставка/удаление в середине для типа с std::unique_ptr
+// с включенным deque_relocatable (memmove) и без него (поэлементный move).
+//
+//   g++ -O2 -std=c++17 bench/relocation.cpp -o relocation && ./relocation [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "../my_deque.h"
+
+template <typename F>
+double measure_ns(int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / repeats;
+}
+
+// одинаковые типы, отличаются только специализацией deque_relocatable
+struct Relocatable {
+    std::unique_ptr<int> value;
+    explicit Relocatable(int v = 0) : value(new int(v)) {}
+};
+
+struct NotRelocatable {
+    std::unique_ptr<int> value;
+    explicit NotRelocatable(int v = 0) : value(new int(v)) {}
+};
+
+template <>
+struct deque_relocatable<Relocatable> : std::true_type {};
+
+template <typename T>
+void middle_ops(const char* name, size_t n) {
+    Deque<T> deq;
+    for (size_t i = 0; i < n; ++i) deq.emplace_back(int(i));
+
+    int ops = 200;
+    double ns = measure_ns(1, [&] {
+        for (int i = 0; i < ops; ++i) deq.emplace(deq.begin() + deq.size() / 2, i);
+        for (int i = 0; i < ops; ++i) deq.erase(deq.begin() + deq.size() / 2);
+    });
+    std::printf("  middle insert+erase %-15s %10.1f us/op\n", name, ns / (2 * ops) / 1000);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    int repeats = 5;
+
+    Deque<uint64_t> deq;
+    std::deque<uint64_t> std_deq;
+    std::vector<uint64_t> vec(n);
+    for (size_t i = 0; i < n; ++i) {
+        deq.push_back(i);
+        std_deq.push_back(i);
+        vec[i] = i;
+    }
+    std::vector<uint64_t> vec_copy(n);
+    double bytes = double(n) * sizeof(uint64_t);
+    volatile size_t sink = 0;
+
+    std::printf("%zu x uint64_t\n", n);
+    double t = measure_ns(repeats, [&] { Deque<uint64_t> copy(deq); sink = copy.size(); });
+    std::printf("  copy Deque                     %8.2f GB/s\n", bytes / t);
+    t = measure_ns(repeats, [&] { std::deque<uint64_t> copy(std_deq); sink = copy.size(); });
+    std::printf("  copy std::deque                %8.2f GB/s\n", bytes / t);
+    t = measure_ns(repeats, [&] { std::memcpy(vec_copy.data(), vec.data(), n * sizeof(uint64_t)); sink = vec_copy[n / 2]; });
+    std::printf("  memcpy (warm destination)      %8.2f GB/s\n", bytes / t);
+    // копия контейнера пишет в свежую память, так что честнее сравнивать с memcpy в новый буфер
+    t = measure_ns(repeats, [&] {
+        std::unique_ptr<uint64_t[]> fresh(new uint64_t[n]);
+        std::memcpy(fresh.get(), vec.data(), n * sizeof(uint64_t));
+        sink = fresh[n / 2];
+    });
+    std::printf("  memcpy (fresh destination)     %8.2f GB/s\n", bytes / t);
+    (void)sink;
+
+    size_t m = n / 10;
+    std::printf("%zu x unique_ptr holder\n", m);
+    middle_ops<Relocatable>("relocatable", m);
+    middle_ops<NotRelocatable>("element-wise", m);
+    middle_ops<uint64_t>("uint64_t", m);
+}
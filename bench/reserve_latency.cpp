@@ -0,0 +1,90 @@
+// Задержка отдельных push_back в начале пачки: без подготовки, после reserve()
+// и в "прогретом" деке (pop_front до пустого, бакеты из пула). Печатает перцентили
+// и число выделений памяти во время пачки; после reserve() их должно быть ноль,
+// иначе бенчмарк завершается с ненулевым кодом.
+//
+//   g++ -O2 -std=c++17 bench/reserve_latency.cpp -o reserve_latency && ./reserve_latency [burst] [rounds]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "../my_deque.h"
+
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// заявка в стакане: 32 байта
+struct Order {
+    uint64_t id;
+    int64_t  price;
+    int64_t  quantity;
+    uint64_t timestamp;
+};
+
+struct Result {
+    std::vector<uint64_t> samples;
+    size_t allocations = 0;
+};
+
+template <typename Prepare>
+Result run(size_t burst, size_t rounds, Prepare prepare) {
+    Result result;
+    result.samples.reserve(burst * rounds);
+    for (size_t r = 0; r < rounds; ++r) {
+        Deque<Order> deq;
+        prepare(deq, burst);
+        size_t allocs = allocation_count;
+        for (size_t i = 0; i < burst; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            deq.push_back(Order{i, int64_t(i), 1, i});
+            auto stop = std::chrono::steady_clock::now();
+            result.samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        }
+        result.allocations += allocation_count - allocs;
+    }
+    return result;
+}
+
+static void report(const char* name, Result& r) {
+    std::sort(r.samples.begin(), r.samples.end());
+    size_t n = r.samples.size();
+    auto pct = [&](double p) { return (unsigned long long)r.samples[std::min(n - 1, size_t(p * n))]; };
+    std::printf("  %-10s p50 %5llu  p99 %6llu  p99.9 %7llu  max %8llu ns   allocations %zu\n",
+                name, pct(0.5), pct(0.99), pct(0.999), (unsigned long long)r.samples.back(), r.allocations);
+}
+
+int main(int argc, char** argv) {
+    size_t burst  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+
+    Result cold = run(burst, rounds, [](Deque<Order>&, size_t) {});
+    Result reserved = run(burst, rounds, [](Deque<Order>& deq, size_t n) { deq.reserve(n); });
+    Result warmed = run(burst, rounds, [](Deque<Order>& deq, size_t n) {
+        // прогрев без reserve(): пачка туда и обратно, бакеты остаются в пуле (не больше spare_limit())
+        for (size_t i = 0; i < n; ++i) deq.push_back(Order{});
+        while (!deq.empty()) deq.pop_front();
+    });
+
+    std::printf("push_back latency, burst %zu x %zu rounds\n", burst, rounds);
+    report("cold", cold);
+    report("warmed", warmed);
+    report("reserve()", reserved);
+    return reserved.allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+// Окно последних window записей: BoundedDeque<bounded_overwrite> против ручного
+// push_back + pop_front по превышению размера (Deque и std::deque). Окно сначала заполняется,
+// затем меряется поток из ops записей: пропускная способность, перцентили задержки отдельной
+// вставки и число выделений памяти в установившемся режиме (у BoundedDeque должно быть ноль,
+// иначе бенчмарк завершается с ненулевым кодом). Перед замерами проверяется push_back(front())
+// в полное окно: аргумент ссылается на вытесняемый элемент.
+//
+//   g++ -O2 -std=c++17 bench/rolling_window.cpp -o rolling_window && ./rolling_window [window] [ops]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../bounded_deque.h"
+
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct Sample {
+    uint64_t timestamp;
+    double   value;
+    uint32_t source;
+    uint32_t flags;
+};
+
+struct Result {
+    double ns_per_op = 0;
+    std::vector<uint64_t> latencies;
+    size_t allocations = 0;
+};
+
+// push(container, sample) кладет запись в окно, удерживая его размер
+template <typename Container, typename Push>
+Result run(Container& window, size_t fill, size_t ops, Push push) {
+    for (size_t i = 0; i < fill; ++i) {
+        push(window, Sample{i, double(i), uint32_t(i & 15), 0});
+    }
+
+    Result result;
+    size_t allocs = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) {
+        push(window, Sample{fill + i, double(i), uint32_t(i & 15), 0});
+    }
+    auto stop = std::chrono::steady_clock::now();
+    result.allocations = allocation_count - allocs;
+    result.ns_per_op   = std::chrono::duration<double, std::nano>(stop - start).count() / ops;
+
+    // задержки отдельно, чтобы вызовы clock не входили в пропускную способность
+    result.latencies.reserve(ops);
+    for (size_t i = 0; i < ops; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        push(window, Sample{fill + ops + i, double(i), uint32_t(i & 15), 0});
+        auto t1 = std::chrono::steady_clock::now();
+        result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    return result;
+}
+
+static void report(const char* name, Result& r) {
+    std::sort(r.latencies.begin(), r.latencies.end());
+    size_t n = r.latencies.size();
+    auto pct = [&](double p) { return (unsigned long long)r.latencies[std::min(n - 1, size_t(p * n))]; };
+    std::printf("  %-26s %6.2f ns/op   p50 %4llu  p99 %5llu  p99.99 %7llu  max %8llu ns   allocations %zu\n",
+                name, r.ns_per_op, pct(0.5), pct(0.99), pct(0.9999), (unsigned long long)r.latencies.back(), r.allocations);
+}
+
+static void check_push_evicted() {
+    BoundedDeque<std::string, bounded_overwrite> deq(2);
+    deq.push_back(std::string(100, 'a'));
+    deq.push_back(std::string(100, 'b'));
+    deq.push_back(deq.front());
+    if (deq.size() != 2 || deq.front() != std::string(100, 'b') || deq.back() != std::string(100, 'a')) {
+        std::printf("push_back(front()) into a full window is broken\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    check_push_evicted();
+
+    size_t window = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t ops    = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+
+    Result bounded;
+    {
+        BoundedDeque<Sample, bounded_overwrite> deq(window);
+        bounded = run(deq, window, ops, [](auto& w, const Sample& s) { w.push_back(s); });
+    }
+
+    Result manual;
+    {
+        Deque<Sample> deq;
+        manual = run(deq, window, ops, [window](auto& w, const Sample& s) {
+            w.push_back(s);
+            if (w.size() > window) w.pop_front();
+        });
+    }
+
+    Result manual_std;
+    {
+        std::deque<Sample> deq;
+        manual_std = run(deq, window, ops, [window](auto& w, const Sample& s) {
+            w.push_back(s);
+            if (w.size() > window) w.pop_front();
+        });
+    }
+
+    std::printf("rolling window of %zu samples (%zu bytes), %zu pushes\n", window, sizeof(Sample), ops);
+    report("BoundedDeque overwrite", bounded);
+    report("Deque push_back+pop_front", manual);
+    report("std::deque push+pop", manual_std);
+    return bounded.allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+// Сканирование Deque<double>: std::accumulate по итераторам против посегментного
+// accumulate() из deque_algorithm.h и того же прохода по std::vector.
+//
+//   g++ -O3 -march=native -std=c++17 bench/segmented_scan.cpp -o segmented_scan && ./segmented_scan [n]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+#include "../deque_algorithm.h"
+
+template <typename F>
+double measure(size_t n, int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(n) * repeats);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    int repeats = 10;
+
+    Deque<double> deq;
+    std::vector<double> vec;
+    for (size_t i = 0; i < n; ++i) {
+        deq.push_back(i * 0.25);
+        vec.push_back(i * 0.25);
+    }
+
+    volatile double sink = 0;
+    // сумма целых нужна, чтобы компилятор мог векторизовать без -ffast-math
+    auto count_big = [](long long acc, double x) { return acc + (x > 1000.0); };
+
+    std::printf("%zu doubles\n", n);
+    std::printf("  sum   iterators  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::accumulate(deq.begin(), deq.end(), 0.0); }));
+    std::printf("  sum   segments   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = accumulate(deq, 0.0); }));
+    std::printf("  sum   vector     %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::accumulate(vec.begin(), vec.end(), 0.0); }));
+    std::printf("  count iterators  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::accumulate(deq.begin(), deq.end(), 0LL, count_big); }));
+    std::printf("  count segments   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = accumulate(deq, 0LL, count_big); }));
+    std::printf("  count vector     %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::accumulate(vec.begin(), vec.end(), 0LL, count_big); }));
+    std::printf("  fill  segments   %6.3f ns/elem\n", measure(n, repeats, [&] { fill(deq, 1.0); }));
+    std::printf("  fill  vector     %6.3f ns/elem\n", measure(n, repeats, [&] { std::fill(vec.begin(), vec.end(), 1.0); }));
+    (void)sink;
+}
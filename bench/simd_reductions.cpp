@@ -0,0 +1,52 @@
+// Векторные ядра из deque_simd.h против стандартных алгоритмов по итераторам Deque.
+// Собирается без -march=native: AVX2-версия ядер выбирается во время выполнения.
+//
+//   g++ -O2 -std=c++17 bench/simd_reductions.cpp -o simd_reductions && ./simd_reductions [n]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+
+#include "../deque_simd.h"
+
+template <typename F>
+double measure(size_t n, int repeats, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(n) * repeats);
+}
+
+template <typename T>
+void run(const char* name, size_t n, int repeats) {
+    Deque<T> deq;
+    for (size_t i = 0; i < n; ++i) deq.push_back(T(i % 1000));
+
+    volatile double sink = 0;
+    // коэффициенты через volatile, чтобы компилятор не свернул x * 1 + 0
+    volatile T va = T(1), vb = T(0);
+    T a = va, b = vb;
+    std::printf("%zu x %s\n", n, name);
+    std::printf("  sum       std   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::accumulate(deq.begin(), deq.end(), deque_simd_detail::sum_t<T>(0)); }));
+    std::printf("  sum       simd  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = simd_sum(deq); }));
+    std::printf("  min       std   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = *std::min_element(deq.begin(), deq.end()); }));
+    std::printf("  min       simd  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = simd_min(deq); }));
+    std::printf("  count     std   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::count(deq.begin(), deq.end(), T(7)); }));
+    std::printf("  count     simd  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = simd_count(deq, T(7)); }));
+    std::printf("  find      std   %6.3f ns/elem\n", measure(n, repeats, [&] { sink = std::find(deq.begin(), deq.end(), T(5000)) - deq.begin(); }));
+    std::printf("  find      simd  %6.3f ns/elem\n", measure(n, repeats, [&] { sink = simd_find(deq, T(5000)); }));
+    std::printf("  scale_add std   %6.3f ns/elem\n", measure(n, repeats, [&] { for (T& x : deq) x = x * a + b; }));
+    std::printf("  scale_add simd  %6.3f ns/elem\n", measure(n, repeats, [&] { simd_scale_add(deq, a, b); }));
+    (void)sink;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    int repeats = 20;
+
+    run<float>("float", n, repeats);
+    run<int32_t>("int32_t", n, repeats);
+    run<int16_t>("int16_t", n, repeats);
+}
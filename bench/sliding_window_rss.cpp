@@ -0,0 +1,52 @@
+// Долгая нагрузка "скользящее окно" (push_back + pop_front): capacity() и RSS процесса
+// должны оставаться пропорциональными размеру окна, а не числу всех вставок.
+//
+//   g++ -O2 -std=c++17 bench/sliding_window_rss.cpp -o sliding_window_rss && ./sliding_window_rss [window] [total]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../my_deque.h"
+
+// VmRSS из /proc/self/status в килобайтах (0, если недоступно)
+static size_t current_rss_kb() {
+    FILE* status = std::fopen("/proc/self/status", "r");
+    if (status == nullptr) return 0;
+    char line[256];
+    size_t rss = 0;
+    while (std::fgets(line, sizeof(line), status) != nullptr) {
+        if (std::strncmp(line, "VmRSS:", 6) == 0) {
+            rss = std::strtoull(line + 6, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(status);
+    return rss;
+}
+
+int main(int argc, char** argv) {
+    size_t window = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t total  = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000000;
+    size_t report = total / 10;
+
+    Deque<long long> deq;
+    for (size_t i = 0; i < window; ++i) {
+        deq.push_back(static_cast<long long>(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto last  = start;
+    for (size_t i = 1; i <= total; ++i) {
+        deq.push_back(static_cast<long long>(i));
+        deq.pop_front();
+        if (i % report == 0) {
+            auto now = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(now - last).count() / report;
+            last = now;
+            std::printf("%12zu pushes: size %zu, capacity %zu, RSS %zu KiB, %.2f ns per push/pop\n",
+                        i, deq.size(), deq.capacity(), current_rss_kb(), ns);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// Много крошечных очередей: на каждое "соединение" создается дек, в него кладется
+// несколько сообщений, они забираются, дек уничтожается. Сравниваются SmallDeque,
+// Deque (пустой дек ничего не выделяет, но первая вставка заводит карту и бакет)
+// и std::deque. Печатает нс на соединение и число выделений памяти на соединение.
+//
+//   g++ -O2 -std=c++17 bench/small_deque.cpp -o small_deque && ./small_deque [connections]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+
+#include "../small_deque.h"
+
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct Message {
+    uint32_t id;
+    uint32_t length;
+    uint64_t offset;
+};
+
+static volatile uint64_t sink;
+
+template <typename Queue>
+void measure(const char* name, size_t connections) {
+    size_t allocs = allocation_count;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < connections; ++c) {
+        Queue queue;
+        size_t messages = 1 + c % 12;  // от 1 до 12 сообщений, все влезают в 16 встроенных слотов
+        for (size_t i = 0; i < messages; ++i) {
+            queue.push_back(Message{uint32_t(i), uint32_t(c), c * i});
+        }
+        while (!queue.empty()) {
+            checksum += queue[0].offset;
+            queue.pop_front();
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    sink = checksum;
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    std::printf("%-14s %8.1f ns/conn  %6.2f allocs/conn\n", name, ns / connections,
+                double(allocation_count - allocs) / connections);
+}
+
+int main(int argc, char** argv) {
+    size_t connections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    measure<SmallDeque<Message, 16>>("SmallDeque<16>", connections);
+    measure<Deque<Message>>("Deque", connections);
+    measure<std::deque<Message>>("std::deque", connections);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Склейка шардов: K деков по n записей сливаются в один. push_back-цикл против splice_back(),
+// когда стыки совпадают по позиции в бакете (n кратно размеру бакета - переходят только указатели)
+// и когда не совпадают (n + 1 - каждый шард переносится memcpy). Затем split_at() пополам
+// против копирования хвоста в новый дек. Время - на всю операцию, заполнение шардов не считается.
+//
+//   g++ -O2 -std=c++17 bench/splice.cpp -o splice && ./splice [n] [shards]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../my_deque.h"
+
+struct Record {
+    long long id;
+    long long timestamp;
+    double    value;
+    int       flags;
+};
+
+using Shard = Deque<Record>;
+
+static std::vector<Shard> make_shards(size_t shards, size_t n) {
+    std::vector<Shard> result(shards);
+    for (size_t s = 0; s < shards; ++s) {
+        for (size_t i = 0; i < n; ++i) {
+            result[s].push_back(Record{static_cast<long long>(s * n + i), 0, 0.0, 0});
+        }
+    }
+    return result;
+}
+
+template <typename F>
+double measure(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+static bool ordered(const Shard& deq) {
+    for (size_t i = 1; i < deq.size(); i += 4099) {
+        if (deq[i].id != deq[i - 1].id + 1) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t n      = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1 << 20);
+    size_t shards = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+    std::printf("%zu shards x %zu records (%zu bytes each)\n", shards, n, sizeof(Record));
+    for (size_t shard_size : {n, n + 1}) {
+        std::vector<Shard> parts = make_shards(shards, shard_size);
+        Shard merged;
+        double ms_push = measure([&] {
+            for (const Shard& part : parts) {
+                for (const Record& r : part) merged.push_back(r);
+            }
+        });
+        if (!ordered(merged)) return 1;
+
+        merged = Shard();
+        double ms_splice = measure([&] {
+            for (Shard& part : parts) merged.splice_back(std::move(part));
+        });
+        if (!ordered(merged) || merged.size() != shards * shard_size) return 1;
+
+        std::printf("  shard of %zu (%s)\n", shard_size, shard_size == n ? "aligned" : "misaligned");
+        std::printf("    push_back loop      %9.3f ms\n", ms_push);
+        std::printf("    splice_back         %9.3f ms\n", ms_splice);
+    }
+
+    Shard whole = std::move(make_shards(1, n * shards)[0]);
+    size_t half = whole.size() / 2 + 1;
+    double ms_copy = measure([&] {
+        Shard tail(whole.begin() + half, whole.end());
+        if (tail.size() != whole.size() - half) std::abort();
+    });
+    Shard tail;
+    double ms_split = measure([&] { tail = whole.split_at(half); });
+    if (tail.size() + whole.size() != n * shards || !ordered(tail)) return 1;
+    std::printf("  split of %zu records in half\n", n * shards);
+    std::printf("    copy of the tail    %9.3f ms\n", ms_copy);
+    std::printf("    split_at            %9.3f ms\n", ms_split);
+}
@@ -0,0 +1,104 @@
+// Передача элементов между двумя потоками: SpscDeque против Deque под std::mutex.
+// Пропускная способность (push_back/pop_front без пауз) и задержка от push до pop
+// (производитель кладет время отправки, потребитель считает разницу).
+// Потребитель проверяет порядок элементов, так что это же и стресс-тест;
+// для проверки гонок собирать с -fsanitize=thread и маленьким n.
+//
+//   g++ -O2 -std=c++17 -pthread bench/spsc_handoff.cpp -o spsc_handoff && ./spsc_handoff [n]
+//   g++ -O1 -g -std=c++17 -fsanitize=thread bench/spsc_handoff.cpp -o spsc_tsan && ./spsc_tsan 200000
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../spsc_deque.h"
+
+using clock_type = std::chrono::steady_clock;
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+}
+
+// Deque под мьютексом с тем же интерфейсом, что у SpscDeque
+struct LockedDeque {
+    std::mutex mutex;
+    Deque<uint64_t> deq;
+
+    void push_back(uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deq.push_back(value);
+    }
+
+    bool try_pop_front(uint64_t& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (deq.empty()) return false;
+        out = deq[0];
+        deq.pop_front();
+        return true;
+    }
+};
+
+template <typename Queue>
+void throughput(const char* name, size_t n) {
+    Queue q;
+    auto start = clock_type::now();
+    std::thread producer([&] {
+        for (size_t i = 0; i < n; ++i) q.push_back(i);
+    });
+
+    uint64_t value = 0;
+    for (size_t expected = 0; expected < n; ) {
+        if (q.try_pop_front(value)) {
+            if (value != expected) {
+                std::printf("%s: order violated at %zu (got %llu)\n", name, expected, (unsigned long long)value);
+                std::exit(1);
+            }
+            ++expected;
+        }
+    }
+    producer.join();
+    auto stop = clock_type::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    std::printf("  %-12s throughput  %7.2f Mops/s\n", name, n / ns * 1e3);
+}
+
+template <typename Queue>
+void latency(const char* name, size_t n) {
+    Queue q;
+    std::vector<uint64_t> samples;
+    samples.reserve(n);
+
+    std::thread producer([&] {
+        // шлем раз в микросекунду, чтобы мерить задержку, а не длину очереди
+        uint64_t next = now_ns();
+        for (size_t i = 0; i < n; ++i) {
+            while (now_ns() < next) {}
+            q.push_back(now_ns());
+            next += 1000;
+        }
+    });
+
+    uint64_t sent = 0;
+    while (samples.size() < n) {
+        if (q.try_pop_front(sent)) samples.push_back(now_ns() - sent);
+    }
+    producer.join();
+
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) { return (unsigned long long)samples[std::min(n - 1, size_t(p * n))]; };
+    std::printf("  %-12s latency     p50 %5llu ns  p99 %6llu ns  p99.9 %7llu ns\n", name, pct(0.5), pct(0.99), pct(0.999));
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+    std::printf("%zu elements\n", n);
+    throughput<SpscDeque<uint64_t>>("SpscDeque", n);
+    throughput<LockedDeque>("mutex+Deque", n);
+    latency<SpscDeque<uint64_t>>("SpscDeque", n / 50);
+    latency<LockedDeque>("mutex+Deque", n / 50);
+}
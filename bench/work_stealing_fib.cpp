@@ -0,0 +1,145 @@
+// Fork-join fib(n) на пуле потоков: у каждого потока свой дек задач, владелец
+// кладет и берет задачи с конца, простаивающие потоки крадут с начала чужих деков.
+// WorkStealingDeque против Deque<Node*> под std::mutex, от 1 до N потоков.
+//
+//   g++ -O2 -std=c++17 -pthread bench/work_stealing_fib.cpp -o work_stealing_fib && ./work_stealing_fib [n] [threads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../work_stealing_deque.h"
+
+// узел дерева вычислений: ждет двух детей, затем отдает сумму родителю
+struct Node {
+    int n;
+    Node* parent;
+    std::atomic<int> pending;
+    std::atomic<long> sum;
+
+    Node(int n, Node* parent) : n(n), parent(parent), pending(2), sum(0) {}
+};
+
+static long fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+struct LockedDeque {
+    std::mutex mutex;
+    Deque<Node*> deq;
+
+    void push_back(Node* node) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deq.push_back(node);
+    }
+
+    bool pop_back(Node*& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (deq.empty()) return false;
+        out = deq[deq.size() - 1];
+        deq.pop_back();
+        return true;
+    }
+
+    bool steal(Node*& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (deq.empty()) return false;
+        out = deq[0];
+        deq.pop_front();
+        return true;
+    }
+};
+
+template <typename Queue>
+class Pool {
+private:
+    static constexpr int cutoff = 12;  // ниже считаем последовательно
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<bool> done;
+    long result;
+
+    void complete(Node* node, long value) {
+        while (true) {
+            Node* parent = node->parent;
+            delete node;
+            if (!parent) {
+                result = value;
+                done.store(true, std::memory_order_release);
+                return;
+            }
+            parent->sum.fetch_add(value, std::memory_order_relaxed);
+            if (parent->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            value = parent->sum.load(std::memory_order_relaxed);
+            node = parent;
+        }
+    }
+
+    void run(Node* node, size_t self) {
+        if (node->n < cutoff) {
+            complete(node, fib_serial(node->n));
+            return;
+        }
+        queues[self]->push_back(new Node(node->n - 2, node));
+        queues[self]->push_back(new Node(node->n - 1, node));
+    }
+
+    void worker(size_t self) {
+        std::minstd_rand rng(unsigned(self) + 1);
+        while (!done.load(std::memory_order_acquire)) {
+            Node* node = nullptr;
+            if (queues[self]->pop_back(node) || queues[rng() % queues.size()]->steal(node)) {
+                run(node, self);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+public:
+    long compute(int n, size_t threads) {
+        queues.clear();
+        for (size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+        done.store(false);
+        queues[0]->push_back(new Node(n, nullptr));
+
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < threads; ++i) pool.emplace_back([this, i] { worker(i); });
+        worker(0);
+        for (auto& t : pool) t.join();
+        return result;
+    }
+};
+
+template <typename Queue>
+void run_series(const char* name, int n, size_t max_threads) {
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) counts.push_back(threads);
+    counts.push_back(max_threads);
+
+    double base = 0;
+    for (size_t threads : counts) {
+        Pool<Queue> pool;
+        auto start = std::chrono::steady_clock::now();
+        long value = pool.compute(n, threads);
+        auto stop = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+        if (threads == 1) base = ms;
+        std::printf("  %-18s threads %2zu  %8.1f ms  speedup %5.2f  (fib = %ld)\n", name, threads, ms, base / ms, value);
+    }
+}
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 36;
+    size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("fib(%d), up to %zu threads\n", n, max_threads);
+    run_series<WorkStealingDeque<Node*>>("WorkStealingDeque", n, max_threads);
+    run_series<LockedDeque>("mutex+Deque", n, max_threads);
+}
@@ -0,0 +1,370 @@
+#ifndef BOUNDED_DEQUE_H
+#define BOUNDED_DEQUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Что делает push_back в заполненной BoundedDeque
+struct bounded_overwrite {};  // вытесняет самый старый элемент
+struct bounded_reject {};     // не вставляет и возвращает false
+struct bounded_block {};      // ждет, пока другой поток не заберет элемент
+
+namespace bounded_detail {
+
+struct no_sync {};
+
+struct blocking_sync {
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+} // namespace bounded_detail
+
+// Очередь фиксированной емкости (например, окно последних N записей).
+//
+// Все бакеты выделяются в конструкторе: ceil(capacity / bucket_size) штук, и дальше
+// переиспользуются по кругу - push/pop не обращаются к аллокатору и не трогают карту.
+// Кольцо - ровно capacity слотов (последний бакет может быть занят не целиком), позиция первого
+// элемента - линейный номер слота head; элемент i лежит в слоте (head + i) по модулю capacity.
+//
+// С bounded_block методы push/emplace/pop/try_pop_front/wait_pop_front и size() берут мьютекс
+// и могут вызываться из разных потоков; остальное (operator[], front/back, for_each_segment)
+// не синхронизировано, как и все методы при других политиках.
+template <typename T, typename Policy = bounded_overwrite, size_t BucketSize = deque_detail::default_bucket_size<T>(),
+          typename Allocator = std::allocator<T>>
+class BoundedDeque {
+private:
+    static_assert(BucketSize > 0, "BoundedDeque: bucket size must be positive");
+    static_assert(std::is_same<Policy, bounded_overwrite>::value || std::is_same<Policy, bounded_reject>::value ||
+                  std::is_same<Policy, bounded_block>::value, "BoundedDeque: unknown policy");
+
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    static constexpr bool blocking = std::is_same<Policy, bounded_block>::value;
+
+    using alloc_traits  = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<T*>;
+    using sync_type     = std::conditional_t<blocking, bounded_detail::blocking_sync, bounded_detail::no_sync>;
+
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value, "BoundedDeque: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value, "BoundedDeque: fancy pointers are not supported");
+
+    Allocator alloc;
+    std::vector<T*, map_allocator> buckets;
+    size_t slots;  // емкость, заданная в конструкторе
+    size_t head;   // слот первого элемента
+    size_t sz;
+    mutable sync_type sync;
+
+    T* slot(size_t lin) const {
+        return buckets[lin >> bucket_shift] + (lin & bucket_mask);
+    }
+
+    size_t advance(size_t lin, size_t n) const {
+        // lin < slots и n <= slots, так что хватает одного вычитания вместо деления
+        lin += n;
+        return lin >= slots ? lin - slots : lin;
+    }
+
+    auto lock() const {
+        if constexpr (blocking) {
+            return std::unique_lock<std::mutex>(sync.mutex);
+        } else {
+            return 0;
+        }
+    }
+
+    void destroy_front();
+    void destroy_all();
+
+public:
+    using value_type     = T;
+    using allocator_type = Allocator;
+    using size_type      = size_t;
+    using policy_type    = Policy;
+
+    explicit BoundedDeque(size_t capacity, const Allocator& allocator = Allocator());
+    BoundedDeque(const BoundedDeque&) = delete;
+    BoundedDeque& operator=(const BoundedDeque&) = delete;
+    ~BoundedDeque();
+
+    // true, если элемент вставлен: false бывает только у bounded_reject при заполненной очереди
+    bool push_back(const T& value);
+    bool push_back(T&& value);
+    template <typename... Args>
+    bool emplace_back(Args&&... args);
+
+    void pop_front();
+    // false, если очередь пуста
+    bool try_pop_front(T& out);
+    // только bounded_block: ждет элемент
+    void wait_pop_front(T& out);
+
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    bool full() const;
+    void clear();
+
+    // обход по непрерывным кускам: не больше bucket_count + 1 вызовов f(first, last);
+    // если f возвращает bool, то false прекращает обход
+    template <typename F>
+    void for_each_segment(F&& f);
+    template <typename F>
+    void for_each_segment(F&& f) const;
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::destroy_front() {
+    alloc_traits::destroy(alloc, slot(head));
+    head = advance(head, 1);
+    --sz;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::destroy_all() {
+    if (!std::is_trivially_destructible<T>::value || !deque_detail::has_plain_destroy<Allocator>::value) {
+        for (size_t i = 0, lin = head; i < sz; ++i, lin = advance(lin, 1)) {
+            alloc_traits::destroy(alloc, slot(lin));
+        }
+    }
+    sz   = 0;
+    head = 0;
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+BoundedDeque<T, Policy, BucketSize, Allocator>::BoundedDeque(size_t capacity, const Allocator& allocator)
+    : alloc(allocator), buckets(map_allocator(alloc)), slots(capacity), head(0), sz(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("BoundedDeque: capacity must be positive");
+    }
+    size_t count = (capacity + bucket_mask) >> bucket_shift;
+    buckets.reserve(count);
+    try {
+        for (size_t b = 0; b < count; ++b) {
+            buckets.push_back(alloc_traits::allocate(alloc, bucket_size));
+        }
+    }
+    catch (...) {
+        for (T* bucket : buckets) {
+            alloc_traits::deallocate(alloc, bucket, bucket_size);
+        }
+        throw;
+    }
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+BoundedDeque<T, Policy, BucketSize, Allocator>::~BoundedDeque() {
+    destroy_all();
+    for (T* bucket : buckets) {
+        alloc_traits::deallocate(alloc, bucket, bucket_size);
+    }
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::push_back(const T& value) {
+    return emplace_back(value);
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::push_back(T&& value) {
+    return emplace_back(std::move(value));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+template <typename... Args>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::emplace_back(Args&&... args) {
+    auto guard = lock();
+    if (sz == slots) {
+        if constexpr (std::is_same<Policy, bounded_overwrite>::value) {
+            // args могут ссылаться на вытесняемый элемент (push_back(front())), а при исключении
+            // из конструктора старый элемент должен остаться: сначала значение, потом вытеснение
+            T value(std::forward<Args>(args)...);
+            destroy_front();
+            alloc_traits::construct(alloc, slot(advance(head, sz)), std::move(value));
+            ++sz;
+            return true;
+        } else if constexpr (std::is_same<Policy, bounded_reject>::value) {
+            return false;
+        } else {
+            sync.not_full.wait(guard, [this] { return sz < slots; });
+        }
+    }
+    alloc_traits::construct(alloc, slot(advance(head, sz)), std::forward<Args>(args)...);
+    ++sz;
+    if constexpr (blocking) {
+        guard.unlock();
+        sync.not_empty.notify_one();
+    }
+    return true;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::pop_front() {
+    auto guard = lock();
+    if (sz == 0) {
+        return;
+    }
+    destroy_front();
+    if constexpr (blocking) {
+        guard.unlock();
+        sync.not_full.notify_one();
+    }
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::try_pop_front(T& out) {
+    auto guard = lock();
+    if (sz == 0) {
+        return false;
+    }
+    out = std::move(*slot(head));
+    destroy_front();
+    if constexpr (blocking) {
+        guard.unlock();
+        sync.not_full.notify_one();
+    }
+    return true;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::wait_pop_front(T& out) {
+    static_assert(blocking, "wait_pop_front(): only for bounded_block");
+    std::unique_lock<std::mutex> guard(sync.mutex);
+    sync.not_empty.wait(guard, [this] { return sz > 0; });
+    out = std::move(*slot(head));
+    destroy_front();
+    guard.unlock();
+    sync.not_full.notify_one();
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+T& BoundedDeque<T, Policy, BucketSize, Allocator>::front() {
+    return *slot(head);
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+const T& BoundedDeque<T, Policy, BucketSize, Allocator>::front() const {
+    return *slot(head);
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+T& BoundedDeque<T, Policy, BucketSize, Allocator>::back() {
+    return *slot(advance(head, sz - 1));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+const T& BoundedDeque<T, Policy, BucketSize, Allocator>::back() const {
+    return *slot(advance(head, sz - 1));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+T& BoundedDeque<T, Policy, BucketSize, Allocator>::operator[](size_t index) {
+    return *slot(advance(head, index));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+const T& BoundedDeque<T, Policy, BucketSize, Allocator>::operator[](size_t index) const {
+    return *slot(advance(head, index));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+T& BoundedDeque<T, Policy, BucketSize, Allocator>::at(size_t index) {
+    return const_cast<T&>(static_cast<const BoundedDeque*>(this)->at(index));
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+const T& BoundedDeque<T, Policy, BucketSize, Allocator>::at(size_t index) const {
+    if (index >= sz) {
+        throw std::out_of_range("at(): out of range");
+    }
+    return (*this)[index];
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+size_t BoundedDeque<T, Policy, BucketSize, Allocator>::size() const {
+    [[maybe_unused]] auto guard = lock();
+    return sz;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+size_t BoundedDeque<T, Policy, BucketSize, Allocator>::capacity() const {
+    return slots;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::empty() const {
+    return sz == 0;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+bool BoundedDeque<T, Policy, BucketSize, Allocator>::full() const {
+    return sz == slots;
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::clear() {
+    auto guard = lock();
+    destroy_all();
+    if constexpr (blocking) {
+        guard.unlock();
+        sync.not_full.notify_all();
+    }
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+template <typename F>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::for_each_segment(F&& f) {
+    static_cast<const BoundedDeque*>(this)->for_each_segment([&f](const T* first, const T* last) {
+        return f(const_cast<T*>(first), const_cast<T*>(last));
+    });
+}
+
+template <typename T, typename Policy, size_t BucketSize, typename Allocator>
+template <typename F>
+void BoundedDeque<T, Policy, BucketSize, Allocator>::for_each_segment(F&& f) const {
+    // кусок не пересекает ни границу бакета, ни конец кольца
+    for (size_t done = 0, lin = head; done < sz; ) {
+        size_t chunk   = std::min({sz - done, bucket_size - (lin & bucket_mask), slots - lin});
+        const T* first = slot(lin);
+        if constexpr (std::is_same<decltype(f(first, first + chunk)), bool>::value) {
+            if (!f(first, first + chunk)) return;
+        } else {
+            f(first, first + chunk);
+        }
+        done += chunk;
+        lin   = advance(lin, chunk);
+    }
+}
+
+#endif /* BOUNDED_DEQUE_H */
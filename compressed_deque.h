@@ -0,0 +1,692 @@
+#ifndef COMPRESSED_DEQUE_H
+#define COMPRESSED_DEQUE_H
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "my_deque.h"
+
+namespace compressed_detail {
+
+inline unsigned bit_width(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return v == 0 ? 0 : 64 - __builtin_clzll(v);
+#else
+    unsigned w = 0;
+    for ( ; v != 0; v >>= 1) ++w;
+    return w;
+#endif
+}
+
+inline uint64_t low_mask(unsigned width) {
+    return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+inline size_t packed_words(size_t n, unsigned width) {
+    return (n * width + 63) / 64;
+}
+
+// n значений value(i) по width бит подряд, младшими битами вперед; words заранее обнулены
+template <typename Value>
+void pack(size_t n, unsigned width, uint64_t* words, Value value) {
+    if (width == 0) return;
+    for (size_t i = 0, bit = 0; i < n; ++i, bit += width) {
+        uint64_t v      = value(i);
+        size_t word     = bit >> 6;
+        unsigned shift  = bit & 63;
+        words[word]    |= v << shift;
+        if (shift + width > 64) {
+            words[word + 1] |= v >> (64 - shift);
+        }
+    }
+}
+
+inline uint64_t unpack(const uint64_t* words, size_t i, unsigned width) {
+    size_t bit     = i * width;
+    size_t word    = bit >> 6;
+    unsigned shift = bit & 63;
+    uint64_t v     = words[word] >> shift;
+    if (shift + width > 64) {
+        v |= words[word + 1] << (64 - shift);
+    }
+    return v & low_mask(width);
+}
+
+// все n значений по порядку: out(i, value) - без пересчета позиции для каждого
+template <typename Out>
+void unpack_all(const uint64_t* words, size_t n, unsigned width, Out out) {
+    if (width == 0) {
+        for (size_t i = 0; i < n; ++i) out(i, uint64_t(0));
+        return;
+    }
+    uint64_t mask  = low_mask(width);
+    uint64_t buf   = 0;  // еще не отданные биты текущего слова
+    unsigned avail = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (avail >= width) {
+            out(i, buf & mask);
+            buf   >>= width;
+            avail  -= width;
+        } else {
+            uint64_t next = *words++;
+            unsigned used = width - avail;
+            out(i, (buf | (next << avail)) & mask);
+            buf   = used == 64 ? 0 : next >> used;
+            avail = 64 - used;
+        }
+    }
+}
+
+} // namespace compressed_detail
+
+struct compressed_memory_usage {
+    size_t live_bytes;   // size() * sizeof(T) - столько занял бы несжатый дек без запаса
+    size_t hot_bytes;    // несжатые бакеты
+    size_t cold_bytes;   // упакованные бакеты
+    size_t cache_bytes;  // буферы распаковки
+    size_t map_bytes;    // карта бакетов
+
+    size_t total_bytes() const {
+        return hot_bytes + cold_bytes + cache_bytes + map_bytes;
+    }
+
+    double ratio() const {
+        return total_bytes() == 0 ? 1.0 : double(live_bytes) / double(total_bytes());
+    }
+};
+
+// Дек целых чисел (счетчики, идентификаторы, метки времени), в котором бакеты вдали от концов
+// хранятся сжатыми. Вставка и удаление - только с концов; концевые бакеты всегда несжатые, так что
+// push/pop работают с обычной памятью.
+//
+// Бакет сжимается, когда становится третьим от конца (при появлении нового концевого бакета), и
+// распаковывается обратно, только когда снова становится концевым - поэтому push/pop на границе
+// бакета не гоняют его туда-обратно. Сжатие - один из двух способов, какой короче:
+//   - frame of reference: значение = min + w-битное смещение;
+//   - дельты: первое значение целиком, дальше x[i] = x[i - 1] + min_delta + w-битное смещение
+//     (для монотонных рядов: подряд идущие id упаковываются в 0 бит на элемент); перед дельтами
+//     лежат опорные значения каждого 16-го элемента (тоже упакованные, как смещения от первого),
+//     чтобы до элемента было не больше 15 шагов.
+// Бакет, который не сжимается, остается несжатым.
+//
+// Итераторы и for_each_segment распаковывают бакет целиком в один из двух буферов распаковки и дальше
+// идут по нему. operator[] берет значение из буфера, если бакет уже там, а иначе достает один элемент
+// из упакованных бит, не вытесняя буферы (случайный доступ не мешает идущим итераторам). Элементы
+// отдаются по значению, и даже константные методы нельзя вызывать из нескольких потоков.
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Allocator = std::allocator<T>>
+class CompressedDeque {
+private:
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t), "CompressedDeque: T must be an integer of at most 64 bits");
+
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    // опорные значения в режиме дельт: элементы anchor_step, 2 * anchor_step, ...
+    static constexpr size_t anchor_step  = 16;
+    static constexpr size_t anchor_count = bucket_size > anchor_step ? (bucket_size - 1) / anchor_step : 0;
+
+    // число буферов распаковки: хватает на два итератора, идущих по разным местам дека
+    static constexpr size_t cache_slots = 2;
+    static constexpr size_t no_bucket   = size_t(-1);
+
+    enum : uint8_t { frame_of_reference, delta };
+
+    using alloc_traits      = std::allocator_traits<Allocator>;
+    using word_allocator    = typename alloc_traits::template rebind_alloc<uint64_t>;
+    using word_alloc_traits = std::allocator_traits<word_allocator>;
+
+    struct bucket {
+        T* raw;            // несжатый бакет или nullptr
+        uint64_t* packed;  // [опорные значения] упакованные значения (nullptr при width == 0)
+        uint64_t base;     // первое значение (для delta)
+        uint64_t reference;
+        uint8_t width;
+        uint8_t anchor_width;  // ширина опорных значений (для delta)
+        uint8_t mode;
+    };
+
+    struct cache_slot {
+        size_t id = no_bucket;
+        T* data = nullptr;
+        uint64_t stamp = 0;
+    };
+
+    using map_type = Deque<bucket, deque_detail::default_bucket_size<bucket>(), typename alloc_traits::template rebind_alloc<bucket>>;
+
+    Allocator alloc;
+    map_type map;
+    size_t sz;
+    size_t first_offset;  // позиция первого элемента в первом бакете
+    size_t front_id;      // номер первого бакета; у бакета постоянный номер front_id + индекс в карте
+
+    mutable cache_slot cache[cache_slots];
+    mutable uint64_t cache_clock;
+
+    T* allocate_raw();
+    void deallocate_raw(T* raw);
+    void deallocate_packed(bucket& b);
+    void invalidate(size_t id) const;
+    const T* find_cached(size_t id) const;
+
+    static uint64_t word(T value) {
+        // знаковые T расширяются через беззнаковый тип того же размера: арифметика по модулю 2^64 обратима
+        return static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+    }
+
+    static size_t anchor_words(const bucket& b);
+    static size_t packed_size(const bucket& b);
+    bool compress(bucket& b);
+    static void decode(const bucket& b, T* out);
+    static T decode_one(const bucket& b, size_t i);
+    const T* bucket_data(size_t index) const;
+    T cached_at(size_t index) const;
+    T* take_end_bucket(size_t candidate, bool has_candidate);
+    void reuse_for_end(size_t index, T* raw);
+
+public:
+    using value_type      = T;
+    using allocator_type  = Allocator;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Итератор только для чтения: значения отдаются копией
+    class const_iterator {
+    private:
+        friend class CompressedDeque;
+
+        const CompressedDeque* owner;
+        size_t index;
+
+        const_iterator(const CompressedDeque* owner, size_t index) : owner(owner), index(index) {}
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = T;
+        using pointer           = void;
+        using reference         = T;
+
+        const_iterator() : owner(nullptr), index(0) {}
+
+        T operator*() const {
+            return owner->cached_at(index);
+        }
+
+        const_iterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++index;
+            return old;
+        }
+
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return index != other.index;
+        }
+    };
+
+    using iterator = const_iterator;
+
+    explicit CompressedDeque(const Allocator& allocator = Allocator());
+    CompressedDeque(CompressedDeque&& other) noexcept;
+    CompressedDeque(const CompressedDeque&) = delete;
+    CompressedDeque& operator=(CompressedDeque&& other) noexcept;
+    CompressedDeque& operator=(const CompressedDeque&) = delete;
+    ~CompressedDeque();
+
+    void swap(CompressedDeque& other) noexcept;
+
+    void push_back(T value);
+    void push_front(T value);
+    void pop_back();
+    void pop_front();
+
+    T front() const;
+    T back() const;
+    T operator[](size_t index) const;
+    T at(size_t index) const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, sz);
+    }
+
+    // f(const T* first, const T* last) по несжатым кускам подряд; если f возвращает bool, false прерывает обход
+    template <typename F>
+    void for_each_segment(F&& f) const;
+
+    compressed_memory_usage memory_usage() const;
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+T* CompressedDeque<T, BucketSize, Allocator>::allocate_raw() {
+    return alloc_traits::allocate(alloc, bucket_size);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::deallocate_raw(T* raw) {
+    if (raw != nullptr) {
+        alloc_traits::deallocate(alloc, raw, bucket_size);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::deallocate_packed(bucket& b) {
+    if (b.packed != nullptr) {
+        word_allocator words(alloc);
+        word_alloc_traits::deallocate(words, b.packed, packed_size(b));
+        b.packed = nullptr;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::invalidate(size_t id) const {
+    for (cache_slot& slot : cache) {
+        if (slot.id == id) slot.id = no_bucket;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t CompressedDeque<T, BucketSize, Allocator>::anchor_words(const bucket& b) {
+    return b.mode == delta && b.width > 0 ? compressed_detail::packed_words(anchor_count, b.anchor_width) : 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t CompressedDeque<T, BucketSize, Allocator>::packed_size(const bucket& b) {
+    if (b.mode == frame_of_reference) {
+        return compressed_detail::packed_words(bucket_size, b.width);
+    }
+    return b.width == 0 ? 0 : anchor_words(b) + compressed_detail::packed_words(bucket_size - 1, b.width);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool CompressedDeque<T, BucketSize, Allocator>::compress(bucket& b) {
+    // сжимаются только внутренние бакеты, а они всегда заполнены целиком
+    const T* raw = b.raw;
+    uint64_t base = word(raw[0]);
+    uint64_t lo = base, hi = lo;
+    uint64_t dlo = ~uint64_t(0), dhi = 0;
+    uint64_t anchor_hi = 0;
+    for (size_t i = 1; i < bucket_size; ++i) {
+        uint64_t v = word(raw[i]);
+        uint64_t d = v - word(raw[i - 1]);
+        lo  = std::min(lo, v);
+        hi  = std::max(hi, v);
+        dlo = std::min(dlo, d);
+        dhi = std::max(dhi, d);
+        if (i % anchor_step == 0) anchor_hi = std::max(anchor_hi, v - base);
+    }
+    bucket by_value{nullptr, nullptr, 0, 0, static_cast<uint8_t>(compressed_detail::bit_width(hi - lo)), 0, frame_of_reference};
+    bucket by_delta{nullptr, nullptr, 0, 0, static_cast<uint8_t>(bucket_size > 1 ? compressed_detail::bit_width(dhi - dlo) : 64),
+                    static_cast<uint8_t>(compressed_detail::bit_width(anchor_hi)), delta};
+    bucket shape = packed_size(by_delta) < packed_size(by_value) ? by_delta : by_value;
+    if (shape.width >= 8 * sizeof(T)) {
+        return false;
+    }
+
+    // память выделяется до изменения b: при bad_alloc бакет остается несжатым
+    unsigned width   = shape.width;
+    uint8_t mode     = shape.mode;
+    size_t words     = packed_size(shape);
+    uint64_t* packed = nullptr;
+    if (words > 0) {
+        word_allocator word_alloc(alloc);
+        packed = word_alloc_traits::allocate(word_alloc, words);
+        std::fill(packed, packed + words, uint64_t(0));
+    }
+    if (mode == delta) {
+        if (width > 0) {
+            compressed_detail::pack(anchor_count, shape.anchor_width, packed,
+                                    [raw, base](size_t k) { return word(raw[(k + 1) * anchor_step]) - base; });
+            compressed_detail::pack(bucket_size - 1, width, packed + anchor_words(shape),
+                                    [raw, dlo](size_t i) { return word(raw[i + 1]) - word(raw[i]) - dlo; });
+        }
+        b.mode      = delta;
+        b.base      = base;
+        b.reference = dlo;
+    } else {
+        compressed_detail::pack(bucket_size, width, packed, [raw, lo](size_t i) { return word(raw[i]) - lo; });
+        b.mode      = frame_of_reference;
+        b.base      = 0;
+        b.reference = lo;
+    }
+    b.packed       = packed;
+    b.width        = static_cast<uint8_t>(width);
+    b.anchor_width = shape.anchor_width;
+    return true;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::decode(const bucket& b, T* out) {
+    uint64_t reference = b.reference;
+    if (b.mode == frame_of_reference) {
+        compressed_detail::unpack_all(b.packed, bucket_size, b.width, [out, reference](size_t i, uint64_t v) {
+            out[i] = static_cast<T>(reference + v);
+        });
+    } else {
+        uint64_t x = b.base;
+        out[0] = static_cast<T>(x);
+        const uint64_t* deltas = b.width == 0 ? nullptr : b.packed + anchor_words(b);
+        compressed_detail::unpack_all(deltas, bucket_size - 1, b.width, [out, reference, &x](size_t i, uint64_t v) {
+            x += reference + v;
+            out[i + 1] = static_cast<T>(x);
+        });
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::decode_one(const bucket& b, size_t i) {
+    if (b.mode == frame_of_reference) {
+        return static_cast<T>(b.reference + (b.width == 0 ? 0 : compressed_detail::unpack(b.packed, i, b.width)));
+    }
+    if (b.width == 0) {
+        return static_cast<T>(b.base + b.reference * i);
+    }
+    // от ближайшего опорного значения слева (слагаемые независимы, так что цикл не ждет предыдущего шага)
+    size_t k               = i / anchor_step;
+    size_t steps           = i - k * anchor_step;
+    const uint64_t* deltas = b.packed + anchor_words(b);
+    uint64_t x             = b.base + b.reference * steps;
+    if (k > 0 && b.anchor_width > 0) {
+        x += compressed_detail::unpack(b.packed, k - 1, b.anchor_width);
+    }
+    for (size_t j = k * anchor_step; j < i; ++j) {
+        x += compressed_detail::unpack(deltas, j, b.width);
+    }
+    return static_cast<T>(x);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+const T* CompressedDeque<T, BucketSize, Allocator>::find_cached(size_t id) const {
+    for (cache_slot& slot : cache) {
+        if (slot.id == id) {
+            slot.stamp = ++cache_clock;
+            return slot.data;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+const T* CompressedDeque<T, BucketSize, Allocator>::bucket_data(size_t index) const {
+    const bucket& b = map[index];
+    if (b.raw != nullptr) {
+        return b.raw;
+    }
+    size_t id = front_id + index;
+    if (const T* data = find_cached(id)) {
+        return data;
+    }
+    cache_slot* victim = &cache[0];
+    for (cache_slot& slot : cache) {
+        if (slot.stamp < victim->stamp) victim = &slot;
+    }
+    if (victim->data == nullptr) {
+        Allocator cache_alloc(alloc);
+        victim->data = alloc_traits::allocate(cache_alloc, bucket_size);
+    }
+    decode(b, victim->data);
+    victim->id    = id;
+    victim->stamp = ++cache_clock;
+    return victim->data;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::cached_at(size_t index) const {
+    // для итератора: бакет распаковывается один раз на проход, а не по 15 шагов на элемент
+    size_t lin = first_offset + index;
+    return bucket_data(lin >> bucket_shift)[lin & bucket_mask];
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T* CompressedDeque<T, BucketSize, Allocator>::take_end_bucket(size_t candidate, bool has_candidate) {
+    // память под новый концевой бакет: если бакет candidate (стал третьим от этого конца)
+    // удалось сжать, берем его освободившуюся память, иначе выделяем новую
+    if (has_candidate && map[candidate].raw != nullptr) {
+        bucket& b = map[candidate];
+        if (compress(b)) {
+            return std::exchange(b.raw, nullptr);
+        }
+    }
+    return allocate_raw();
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::reuse_for_end(size_t index, T* raw) {
+    // бакет index стал концевым: если он сжат, распаковываем его в память только что
+    // освободившегося бакета raw - pop не выделяет память и не бросает
+    bucket& b = map[index];
+    if (b.raw != nullptr) {
+        deallocate_raw(raw);
+        return;
+    }
+    decode(b, raw);
+    deallocate_packed(b);
+    b.raw = raw;
+    invalidate(front_id + index);
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+CompressedDeque<T, BucketSize, Allocator>::CompressedDeque(const Allocator& allocator)
+    : alloc(allocator), map(typename alloc_traits::template rebind_alloc<bucket>(alloc)), sz(0), first_offset(0),
+      front_id(size_t(-1) / 2), cache_clock(0) {}
+
+template <typename T, size_t BucketSize, typename Allocator>
+CompressedDeque<T, BucketSize, Allocator>::CompressedDeque(CompressedDeque&& other) noexcept
+    : alloc(other.alloc), map(std::move(other.map)), sz(std::exchange(other.sz, 0)),
+      first_offset(std::exchange(other.first_offset, 0)), front_id(other.front_id), cache_clock(other.cache_clock) {
+    std::swap(cache, other.cache);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+CompressedDeque<T, BucketSize, Allocator>& CompressedDeque<T, BucketSize, Allocator>::operator=(CompressedDeque&& other) noexcept {
+    CompressedDeque tmp(std::move(other));
+    swap(tmp);
+    return *this;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+CompressedDeque<T, BucketSize, Allocator>::~CompressedDeque() {
+    clear();
+    for (cache_slot& slot : cache) {
+        deallocate_raw(slot.data);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::swap(CompressedDeque& other) noexcept {
+    using std::swap;
+    swap(alloc, other.alloc);
+    map.swap(other.map);
+    swap(sz, other.sz);
+    swap(first_offset, other.first_offset);
+    swap(front_id, other.front_id);
+    swap(cache, other.cache);
+    swap(cache_clock, other.cache_clock);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::push_back(T value) {
+    size_t end = first_offset + sz;
+    if (map.empty() || end == (map.size() << bucket_shift)) {
+        if (map.empty()) {
+            first_offset = end = 0;
+        }
+        // после вставки бакет map.size() - 2 станет третьим с конца; первый бакет не трогаем
+        T* raw = take_end_bucket(map.size() - 2, map.size() >= 3);
+        try {
+            map.push_back(bucket{raw, nullptr, 0, 0, 0, 0, frame_of_reference});
+        } catch (...) {
+            deallocate_raw(raw);
+            throw;
+        }
+    }
+    map[map.size() - 1].raw[end & bucket_mask] = value;
+    ++sz;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::push_front(T value) {
+    if (map.empty() || first_offset == 0) {
+        T* raw = take_end_bucket(1, map.size() >= 3);
+        try {
+            map.push_front(bucket{raw, nullptr, 0, 0, 0, 0, frame_of_reference});
+        } catch (...) {
+            deallocate_raw(raw);
+            throw;
+        }
+        --front_id;
+        first_offset = bucket_size;
+    }
+    --first_offset;
+    map[0].raw[first_offset] = value;
+    ++sz;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::pop_back() {
+    if (--sz == 0) {
+        clear();
+        return;
+    }
+    // последний бакет опустел
+    if (first_offset + sz == ((map.size() - 1) << bucket_shift)) {
+        T* raw = map[map.size() - 1].raw;
+        map.pop_back();
+        reuse_for_end(map.size() - 1, raw);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::pop_front() {
+    --sz;
+    if (sz == 0) {
+        clear();
+        return;
+    }
+    if (++first_offset == bucket_size) {
+        T* raw = map[0].raw;
+        map.pop_front();
+        ++front_id;
+        first_offset = 0;
+        reuse_for_end(0, raw);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::front() const {
+    return map[0].raw[first_offset];
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::back() const {
+    return map[map.size() - 1].raw[(first_offset + sz - 1) & bucket_mask];
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::operator[](size_t index) const {
+    size_t lin      = first_offset + index;
+    const bucket& b = map[lin >> bucket_shift];
+    if (b.raw != nullptr) {
+        return b.raw[lin & bucket_mask];
+    }
+    if (const T* data = find_cached(front_id + (lin >> bucket_shift))) {
+        return data[lin & bucket_mask];
+    }
+    return decode_one(b, lin & bucket_mask);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+T CompressedDeque<T, BucketSize, Allocator>::at(size_t index) const {
+    if (index >= sz) {
+        throw std::out_of_range("CompressedDeque::at(): index out of range");
+    }
+    return (*this)[index];
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t CompressedDeque<T, BucketSize, Allocator>::size() const {
+    return sz;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool CompressedDeque<T, BucketSize, Allocator>::empty() const {
+    return sz == 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void CompressedDeque<T, BucketSize, Allocator>::clear() {
+    for (bucket& b : map) {
+        deallocate_raw(b.raw);
+        deallocate_packed(b);
+    }
+    map.clear();
+    for (cache_slot& slot : cache) {
+        slot.id = no_bucket;
+    }
+    sz           = 0;
+    first_offset = 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+template <typename F>
+void CompressedDeque<T, BucketSize, Allocator>::for_each_segment(F&& f) const {
+    for (size_t done = 0, lin = first_offset; done < sz; ) {
+        size_t chunk   = std::min(sz - done, bucket_size - (lin & bucket_mask));
+        const T* first = bucket_data(lin >> bucket_shift) + (lin & bucket_mask);
+        if constexpr (std::is_same<decltype(f(first, first + chunk)), bool>::value) {
+            if (!f(first, first + chunk)) return;
+        } else {
+            f(first, first + chunk);
+        }
+        done += chunk;
+        lin  += chunk;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+compressed_memory_usage CompressedDeque<T, BucketSize, Allocator>::memory_usage() const {
+    compressed_memory_usage usage{sz * sizeof(T), 0, 0, 0, map.memory_usage().total_bytes()};
+    for (const bucket& b : map) {
+        if (b.raw != nullptr) {
+            usage.hot_bytes += bucket_size * sizeof(T);
+        } else {
+            usage.cold_bytes += packed_size(b) * sizeof(uint64_t);
+        }
+    }
+    for (const cache_slot& slot : cache) {
+        if (slot.data != nullptr) usage.cache_bytes += bucket_size * sizeof(T);
+    }
+    return usage;
+}
+
+#endif /* COMPRESSED_DEQUE_H */
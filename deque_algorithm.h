@@ -0,0 +1,81 @@
+#ifndef DEQUE_ALGORITHM_H
+#define DEQUE_ALGORITHM_H
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Алгоритмы над Deque, работающие по бакетам: внутренний цикл идет по непрерывному
+// куску памяти, поэтому компилятор может его векторизовать, а для указателей
+// std::copy/std::fill превращаются в memmove/memset.
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename OutputIt>
+OutputIt copy(const Deque<T, BucketSize, Allocator, Stats>& deq, OutputIt out) {
+    deq.for_each_segment([&out](const T* first, const T* last) {
+        out = std::copy(first, last, out);
+    });
+    return out;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void fill(Deque<T, BucketSize, Allocator, Stats>& deq, const T& value) {
+    deq.for_each_segment([&value](T* first, T* last) {
+        std::fill(first, last, value);
+    });
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator find(Deque<T, BucketSize, Allocator, Stats>& deq, const T& value) {
+    size_t index = 0;
+    deq.for_each_segment([&index, &value](T* first, T* last) {
+        T* it = std::find(first, last, value);
+        index += it - first;
+        return it == last;
+    });
+    return deq.begin() + index;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_iterator find(const Deque<T, BucketSize, Allocator, Stats>& deq, const T& value) {
+    size_t index = 0;
+    deq.for_each_segment([&index, &value](const T* first, const T* last) {
+        const T* it = std::find(first, last, value);
+        index += it - first;
+        return it == last;
+    });
+    return deq.begin() + index;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename Init, typename BinaryOp>
+Init accumulate(const Deque<T, BucketSize, Allocator, Stats>& deq, Init init, BinaryOp op) {
+    deq.for_each_segment([&init, &op](const T* first, const T* last) {
+        init = std::accumulate(first, last, std::move(init), op);
+    });
+    return init;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename Init>
+Init accumulate(const Deque<T, BucketSize, Allocator, Stats>& deq, Init init) {
+    return accumulate(deq, std::move(init), std::plus<>());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename OutputIt, typename UnaryOp>
+OutputIt transform(const Deque<T, BucketSize, Allocator, Stats>& deq, OutputIt out, UnaryOp op) {
+    deq.for_each_segment([&out, &op](const T* first, const T* last) {
+        out = std::transform(first, last, out, op);
+    });
+    return out;
+}
+
+// преобразование на месте
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename UnaryOp>
+void transform(Deque<T, BucketSize, Allocator, Stats>& deq, UnaryOp op) {
+    deq.for_each_segment([&op](T* first, T* last) {
+        std::transform(first, last, first, op);
+    });
+}
+
+#endif /* DEQUE_ALGORITHM_H */
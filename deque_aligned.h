@@ -0,0 +1,246 @@
+#ifndef DEQUE_ALIGNED_H
+#define DEQUE_ALIGNED_H
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "my_deque.h"
+
+namespace deque_detail {
+
+constexpr size_t cache_line_size = 64;
+constexpr size_t page_size       = 4096;
+constexpr size_t huge_page_size  = size_t(2) << 20;
+
+constexpr size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+// Память под бакеты кусками по huge_page_size, выровненными на huge_page_size и помеченными
+// madvise(MADV_HUGEPAGE): при включенных transparent huge pages ядро отдает их страницами по 2 MiB,
+// и один элемент TLB покрывает сотни бакетов. Освобожденные блоки ложатся в список своего размера
+// и переиспользуются; сами куски возвращаются системе только в деструкторе.
+// Запросы больше четверти куска отображаются отдельно и освобождаются сразу.
+// Блоки выровнены и округлены до строки кэша, так что соседние бакеты не делят строку.
+// Общая для всех копий аллокатора, поэтому под мьютексом.
+class huge_page_arena {
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    struct size_class {
+        size_t size;
+        size_t align;
+        free_block* head;
+    };
+
+    static constexpr size_t large_threshold = huge_page_size / 4;
+
+    std::mutex mutex;
+    std::vector<void*> chunks;
+    std::vector<size_class> classes;
+    unsigned char* bump     = nullptr;
+    unsigned char* bump_end = nullptr;
+
+    static size_t mapping_size(size_t bytes) {
+        return round_up(bytes, page_size);
+    }
+
+    // bytes (кратно page_size) с выравниванием на huge_page_size: отображаем с запасом и обрезаем края
+    static void* map_aligned(size_t bytes) {
+        void* raw = mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        uintptr_t start   = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = round_up(start, huge_page_size);
+        if (aligned > start) {
+            munmap(raw, aligned - start);
+        }
+        munmap(reinterpret_cast<void*>(aligned + bytes), huge_page_size - (aligned - start));
+#ifdef MADV_HUGEPAGE
+        // только совет: если THP выключены, останутся обычные страницы
+        madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    size_class& find_class(size_t size, size_t align) {
+        for (size_class& c : classes) {
+            if (c.size == size && c.align == align) return c;
+        }
+        classes.push_back(size_class{size, align, nullptr});
+        return classes.back();
+    }
+
+public:
+    huge_page_arena() = default;
+    huge_page_arena(const huge_page_arena&) = delete;
+    huge_page_arena& operator=(const huge_page_arena&) = delete;
+
+    ~huge_page_arena() {
+        for (void* chunk : chunks) {
+            munmap(chunk, huge_page_size);
+        }
+    }
+
+    void* allocate(size_t bytes, size_t align) {
+        align       = std::max(align, cache_line_size);
+        size_t size = round_up(std::max(bytes, size_t(1)), align);
+        if (size > large_threshold) {
+            return map_aligned(mapping_size(size));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        size_class& c = find_class(size, align);
+        if (c.head != nullptr) {
+            free_block* block = c.head;
+            c.head = block->next;
+            return block;
+        }
+
+        unsigned char* p = reinterpret_cast<unsigned char*>(round_up(reinterpret_cast<uintptr_t>(bump), align));
+        if (bump == nullptr || p + size > bump_end) {
+            // остаток старого куска пропадает - он меньше large_threshold
+            chunks.reserve(chunks.size() + 1);
+            p        = static_cast<unsigned char*>(map_aligned(huge_page_size));
+            bump_end = p + huge_page_size;
+            chunks.push_back(p);
+        }
+        bump = p + size;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes, size_t align) {
+        align       = std::max(align, cache_line_size);
+        size_t size = round_up(std::max(bytes, size_t(1)), align);
+        if (size > large_threshold) {
+            munmap(p, mapping_size(size));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        size_class& c = find_class(size, align);
+        c.head = ::new (p) free_block{c.head};
+    }
+};
+
+} // namespace deque_detail
+
+// Аллокатор с выравниванием каждого выделения на Alignment байт (не меньше alignof(T)):
+// 64 - бакет начинается со строки кэша, 4096 - со страницы, и бакет в 4 KiB (размер по умолчанию)
+// занимает ровно одну страницу, а не две.
+template <typename T, size_t Alignment = deque_detail::cache_line_size>
+class deque_aligned_allocator {
+public:
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+    static_assert((alignment & (alignment - 1)) == 0, "deque_aligned_allocator: alignment must be a power of two");
+
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = deque_aligned_allocator<U, Alignment>;
+    };
+
+    deque_aligned_allocator() noexcept = default;
+
+    template <typename U>
+    deque_aligned_allocator(const deque_aligned_allocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const deque_aligned_allocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const deque_aligned_allocator<U, Alignment>&) const { return false; }
+};
+
+// Аллокатор поверх huge_page_arena (POSIX): для больших деков, которые обходят целиком.
+// Каждый аллокатор, созданный конструктором по умолчанию, заводит свою арену; копии и rebind-копии
+// (в том числе карта дека и копии самого дека) делят ее, и память арены живет, пока жива хоть одна копия.
+// Блоки выровнены на строку кэша (или alignof(T), если он больше).
+template <typename T>
+class deque_huge_page_allocator {
+private:
+    template <typename U>
+    friend class deque_huge_page_allocator;
+
+    std::shared_ptr<deque_detail::huge_page_arena> arena;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    deque_huge_page_allocator() : arena(std::make_shared<deque_detail::huge_page_arena>()) {}
+
+    // перемещения нет намеренно: оно обнулило бы arena, а Deque(Deque&&) перемещает аллокатор
+    // и потом продолжает им пользоваться в опустевшем деке; поэтому перемещение - это копия
+    deque_huge_page_allocator(const deque_huge_page_allocator& other) noexcept = default;
+    deque_huge_page_allocator& operator=(const deque_huge_page_allocator& other) noexcept = default;
+
+    template <typename U>
+    deque_huge_page_allocator(const deque_huge_page_allocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        arena->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const deque_huge_page_allocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const deque_huge_page_allocator<U>& other) const { return arena != other.arena; }
+};
+
+namespace deque_detail {
+
+template <typename U, size_t Alignment>
+struct has_plain_destroy<deque_aligned_allocator<U, Alignment>> : std::true_type {};
+
+template <typename U, size_t Alignment>
+struct has_plain_construct<deque_aligned_allocator<U, Alignment>> : std::true_type {};
+
+template <typename U>
+struct has_plain_destroy<deque_huge_page_allocator<U>> : std::true_type {};
+
+template <typename U>
+struct has_plain_construct<deque_huge_page_allocator<U>> : std::true_type {};
+
+} // namespace deque_detail
+
+namespace huge_pages {
+
+// Deque, бакеты которого лежат на transparent huge pages
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Stats = deque_no_stats>
+using Deque = ::Deque<T, BucketSize, deque_huge_page_allocator<T>, Stats>;
+
+} // namespace huge_pages
+
+#endif /* DEQUE_ALIGNED_H */
@@ -0,0 +1,424 @@
+#ifndef DEQUE_CHANNEL_H
+#define DEQUE_CHANNEL_H
+
+// Заголовок требует C++20 (корутины), остальная библиотека - C++17
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "deque_channel.h requires C++20 coroutines (-std=c++20)"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+class channel_executor;
+
+// Корутина, которую запускает channel_executor::spawn(): стартует на исполнителе, а по завершении
+// уничтожает себя сама. Исключение, вылетевшее из нее, - std::terminate.
+class channel_task {
+public:
+    struct promise_type {
+        channel_task get_return_object() {
+            return channel_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    channel_task(channel_task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    channel_task(const channel_task&) = delete;
+    channel_task& operator=(const channel_task&) = delete;
+
+    // корутина, так и не отданная исполнителю, уничтожается не начавшись
+    ~channel_task() {
+        if (handle) handle.destroy();
+    }
+
+private:
+    friend class channel_executor;
+
+    std::coroutine_handle<> handle;
+
+    explicit channel_task(std::coroutine_handle<> handle) : handle(handle) {}
+};
+
+// Однопоточный исполнитель: очередь готовых к продолжению корутин (Deque хэндлов) и цикл,
+// который их возобновляет. Для нескольких потоков заводится по исполнителю на поток; post() можно
+// звать из любого потока, run()/run_ready() - только из своего.
+// Корутина, уснувшая в Channel, продолжается на том исполнителе, на котором уснула.
+class channel_executor {
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    Deque<std::coroutine_handle<>> ready;
+    Deque<std::coroutine_handle<>> running;  // забранная из ready пачка; бакеты переиспользуются
+    bool stopping = false;
+
+    static channel_executor*& current_slot() {
+        static thread_local channel_executor* current = nullptr;
+        return current;
+    }
+
+    void resume_running();
+
+public:
+    channel_executor() = default;
+    channel_executor(const channel_executor&) = delete;
+    channel_executor& operator=(const channel_executor&) = delete;
+
+    void post(std::coroutine_handle<> handle);
+    void spawn(channel_task task);
+
+    // Возобновляет готовые корутины, пока они есть (в том числе ставшие готовыми по ходу);
+    // возвращает число возобновлений
+    size_t run_ready();
+    // Работает до stop(), засыпая на пустой очереди; готовые к моменту stop() корутины еще выполняются
+    void run();
+    void stop();
+
+    // исполнитель, в run()/run_ready() которого сейчас находится поток, или nullptr
+    static channel_executor* current() {
+        return current_slot();
+    }
+
+    // co_await executor.schedule() переносит корутину на этот исполнитель
+    auto schedule() {
+        struct awaiter {
+            channel_executor* executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor->post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{this};
+    }
+};
+
+// Канал между корутинами поверх Deque<T>:
+//   - co_await ch.pop() отдает std::optional<T>; на пустом канале корутина засыпает,
+//     на пустом закрытом - получает std::nullopt;
+//   - co_await ch.push(v) отдает false, если канал закрыт; при заполненной емкости корутина засыпает.
+// Значение передается ждущей корутине из рук в руки (минуя Deque), и она ставится в очередь своего
+// исполнителя; корутина, уснувшая вне исполнителя, возобновляется прямо в потоке, который ее разбудил.
+// Емкость 0 - рандеву: push ждет, пока значение не заберет pop. Ждущие обслуживаются по порядку.
+//
+// Состояние под мьютексом, так что с одним каналом могут работать корутины разных потоков
+// (и обычные потоки - через try_push/try_pop). Канал нельзя уничтожать, пока в нем кто-то ждет.
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Allocator = std::allocator<T>>
+class Channel {
+private:
+    struct waiter {
+        std::coroutine_handle<> handle;
+        channel_executor* executor;
+        waiter* next;
+    };
+
+    struct pop_awaiter;
+    struct push_awaiter;
+
+    // очередь ждущих по порядку прихода; узлы - сами awaiter'ы в кадрах корутин
+    template <typename Node>
+    struct waiter_list {
+        Node* head = nullptr;
+        Node* tail = nullptr;
+
+        void push(Node* node) {
+            node->next = nullptr;
+            if (tail != nullptr) tail->next = node;
+            else head = node;
+            tail = node;
+        }
+
+        Node* pop() {
+            Node* node = head;
+            if (node != nullptr) {
+                head = static_cast<Node*>(node->next);
+                if (head == nullptr) tail = nullptr;
+            }
+            return node;
+        }
+    };
+
+    std::mutex mutex;
+    Deque<T, BucketSize, Allocator> items;
+    size_t cap;
+    bool closed = false;
+    waiter_list<pop_awaiter> poppers;   // ждут элемента; items при этом пуст
+    waiter_list<push_awaiter> pushers;  // ждут места; items при этом заполнен
+
+    static void wake(waiter* w);
+
+    // под мьютексом: забирает элемент, если он есть; false - ждать (или канал закрыт и пуст)
+    bool take(std::optional<T>& out, waiter*& to_wake);
+    // под мьютексом: отдает значение, если есть ждущий pop или место; false - ждать
+    bool give(T& value, waiter*& to_wake);
+
+    struct pop_awaiter : waiter {
+        Channel* channel;
+        std::optional<T> value;
+
+        explicit pop_awaiter(Channel* channel) : waiter{}, channel(channel) {}
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        std::optional<T> await_resume() { return std::move(value); }
+    };
+
+    struct push_awaiter : waiter {
+        Channel* channel;
+        T value;
+        bool accepted = false;
+
+        push_awaiter(Channel* channel, T&& value) : waiter{}, channel(channel), value(std::move(value)) {}
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const noexcept { return accepted; }
+    };
+
+public:
+    using value_type     = T;
+    using allocator_type = Allocator;
+
+    static constexpr size_t unbounded = size_t(-1);
+
+    explicit Channel(size_t capacity = unbounded, const Allocator& allocator = Allocator());
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    [[nodiscard]] pop_awaiter pop() {
+        return pop_awaiter(this);
+    }
+
+    [[nodiscard]] push_awaiter push(T value) {
+        return push_awaiter(this, std::move(value));
+    }
+
+    // Без ожидания, для кода вне корутин: false / std::nullopt там, где co_await уснул бы
+    bool try_push(T value);
+    std::optional<T> try_pop();
+
+    // Будит всех ждущих: pop получают std::nullopt, push - false. Лежащие элементы еще можно забрать
+    void close();
+
+    bool is_closed();
+    size_t size();
+    size_t capacity() const {
+        return cap;
+    }
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+inline void channel_executor::resume_running() {
+    channel_executor* outer = std::exchange(current_slot(), this);
+    for (std::coroutine_handle<> handle : running) {
+        handle.resume();
+    }
+    running.clear();
+    current_slot() = outer;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void Channel<T, BucketSize, Allocator>::wake(waiter* w) {
+    // вызывается без мьютекса канала: проснувшаяся корутина может сразу снова к нему обратиться
+    if (w == nullptr) return;
+    if (w->executor != nullptr) {
+        w->executor->post(w->handle);
+    } else {
+        w->handle.resume();
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::take(std::optional<T>& out, waiter*& to_wake) {
+    if (!items.empty()) {
+        out.emplace(std::move(items[0]));
+        items.pop_front();
+        // освободилось место: первый ждущий push дописывает свое значение
+        if (push_awaiter* pusher = pushers.pop()) {
+            items.push_back(std::move(pusher->value));
+            pusher->accepted = true;
+            to_wake = pusher;
+        }
+        return true;
+    }
+    if (push_awaiter* pusher = pushers.pop()) {
+        // рандеву: значение прямо из ждущего push
+        out.emplace(std::move(pusher->value));
+        pusher->accepted = true;
+        to_wake = pusher;
+        return true;
+    }
+    return closed;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::give(T& value, waiter*& to_wake) {
+    if (pop_awaiter* popper = poppers.pop()) {
+        popper->value.emplace(std::move(value));
+        to_wake = popper;
+        return true;
+    }
+    if (items.size() < cap) {
+        items.push_back(std::move(value));
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::pop_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    waiter* to_wake = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (!channel->take(value, to_wake)) {
+            // после push в список корутину может возобновить другой поток: кадр больше не трогаем
+            this->handle   = handle;
+            this->executor = channel_executor::current();
+            channel->poppers.push(this);
+            return true;
+        }
+    }
+    wake(to_wake);
+    return false;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::push_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    waiter* to_wake = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(channel->mutex);
+        if (channel->closed) {
+            return false;
+        }
+        if (!channel->give(value, to_wake)) {
+            this->handle   = handle;
+            this->executor = channel_executor::current();
+            channel->pushers.push(this);
+            return true;
+        }
+        accepted = true;
+    }
+    wake(to_wake);
+    return false;
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+inline void channel_executor::post(std::coroutine_handle<> handle) {
+    // notify под мьютексом: исполнитель может быть уничтожен сразу, как только run() вернется
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.push_back(handle);
+    wake.notify_one();
+}
+
+inline void channel_executor::spawn(channel_task task) {
+    post(std::exchange(task.handle, nullptr));
+}
+
+inline size_t channel_executor::run_ready() {
+    size_t resumed = 0;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ready.empty()) return resumed;
+            ready.swap(running);
+        }
+        resumed += running.size();
+        resume_running();
+    }
+}
+
+inline void channel_executor::run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !ready.empty(); });
+            if (ready.empty()) {
+                stopping = false;
+                return;
+            }
+            ready.swap(running);
+        }
+        resume_running();
+    }
+}
+
+inline void channel_executor::stop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    wake.notify_one();
+}
+
+
+template <typename T, size_t BucketSize, typename Allocator>
+Channel<T, BucketSize, Allocator>::Channel(size_t capacity, const Allocator& allocator) : items(allocator), cap(capacity) {}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::try_push(T value) {
+    waiter* to_wake = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed || !give(value, to_wake)) {
+            return false;
+        }
+    }
+    wake(to_wake);
+    return true;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+std::optional<T> Channel<T, BucketSize, Allocator>::try_pop() {
+    std::optional<T> out;
+    waiter* to_wake = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        take(out, to_wake);
+    }
+    wake(to_wake);
+    return out;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void Channel<T, BucketSize, Allocator>::close() {
+    waiter_list<pop_awaiter> pops;
+    waiter_list<push_awaiter> pushes;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        std::swap(pops, poppers);
+        std::swap(pushes, pushers);
+    }
+    // next читаем до wake: после него кадр ждущего может быть уже уничтожен
+    for (pop_awaiter* w = pops.head; w != nullptr; ) {
+        pop_awaiter* next = static_cast<pop_awaiter*>(w->next);
+        wake(w);
+        w = next;
+    }
+    for (push_awaiter* w = pushes.head; w != nullptr; ) {
+        push_awaiter* next = static_cast<push_awaiter*>(w->next);
+        wake(w);
+        w = next;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool Channel<T, BucketSize, Allocator>::is_closed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return closed;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t Channel<T, BucketSize, Allocator>::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return items.size();
+}
+
+#endif /* DEQUE_CHANNEL_H */
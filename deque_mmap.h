@@ -0,0 +1,136 @@
+#ifndef DEQUE_MMAP_H
+#define DEQUE_MMAP_H
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "my_deque.h"
+
+namespace deque_detail {
+
+// отображение файла; общее для всех rebind-копий аллокатора
+struct file_mapping {
+    unsigned char* data;
+    size_t size;
+
+    file_mapping(unsigned char* data, size_t size) : data(data), size(size) {}
+    file_mapping(const file_mapping&) = delete;
+    file_mapping& operator=(const file_mapping&) = delete;
+    ~file_mapping() { munmap(data, size); }
+};
+
+} // namespace deque_detail
+
+// Аллокатор для Deque::load_mapped() (POSIX): держит отображение файла, записанного Deque::save().
+// Бакеты, взятые из файла, лежат внутри отображения и не освобождаются по одному - память
+// возвращается munmap, когда уходит последний аллокатор с этим отображением. Новые бакеты и
+// карта берутся у std::allocator, как обычно.
+//
+// Файл отображается MAP_PRIVATE: запись в элементы копирует страницу, сам файл не меняется.
+// Чтобы сохранить изменения, нужно снова вызвать save().
+template <typename T>
+class deque_mapped_allocator {
+private:
+    template <typename U>
+    friend class deque_mapped_allocator;
+
+    using mapping = deque_detail::file_mapping;
+
+    std::shared_ptr<mapping> map;
+
+    bool owns(const void* p) const {
+        const unsigned char* byte = static_cast<const unsigned char*>(p);
+        return map && byte >= map->data && byte < map->data + map->size;
+    }
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    deque_mapped_allocator() noexcept = default;
+
+    template <typename U>
+    deque_mapped_allocator(const deque_mapped_allocator<U>& other) noexcept : map(other.map) {}
+
+    T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+
+    void deallocate(T* p, size_t n) {
+        if (!owns(p)) {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    // копия дека не ссылается на файл: все ее бакеты выделяются заново
+    deque_mapped_allocator select_on_container_copy_construction() const { return deque_mapped_allocator(); }
+
+    unsigned char* mapped_data() const { return map ? map->data : nullptr; }
+    size_t mapped_size() const { return map ? map->size : 0; }
+
+    // бросает std::system_error, если файл не открылся или не отобразился
+    static deque_mapped_allocator map_file(const std::string& path);
+
+    template <typename U>
+    bool operator==(const deque_mapped_allocator<U>& other) const { return map == other.map; }
+    template <typename U>
+    bool operator!=(const deque_mapped_allocator<U>& other) const { return map != other.map; }
+};
+
+template <typename T>
+deque_mapped_allocator<T> deque_mapped_allocator<T>::map_file(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "map_file(): cannot open " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "map_file(): cannot stat " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data  = size == 0 ? MAP_FAILED : mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int error   = size == 0 ? EINVAL : errno;
+    close(fd); // отображение остается действительным и без дескриптора
+    if (data == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "map_file(): cannot map " + path);
+    }
+
+    deque_mapped_allocator result;
+    try {
+        result.map = std::make_shared<mapping>(static_cast<unsigned char*>(data), size);
+    } catch (...) {
+        munmap(data, size);
+        throw;
+    }
+    return result;
+}
+
+namespace deque_detail {
+
+template <typename U>
+struct has_plain_destroy<deque_mapped_allocator<U>> : std::true_type {};
+
+template <typename U>
+struct has_plain_construct<deque_mapped_allocator<U>> : std::true_type {};
+
+} // namespace deque_detail
+
+namespace mapped {
+
+// Deque, который можно открыть через load_mapped()
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Stats = deque_no_stats>
+using Deque = ::Deque<T, BucketSize, deque_mapped_allocator<T>, Stats>;
+
+} // namespace mapped
+
+#endif /* DEQUE_MMAP_H */
@@ -0,0 +1,328 @@
+#ifndef DEQUE_PARALLEL_H
+#define DEQUE_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Параллельные sort/for_each/transform/reduce/copy для Deque.
+//
+// Вместо std::execution-политик (в libstdc++ они требуют TBB) первым аргументом
+// передается DequeThreadPool - пул потоков, который создается один раз и переиспользуется
+// между вызовами; вызывающий поток тоже берет задачи, так что пул на 1 поток
+// выполняет все последовательно без синхронизации.
+//
+// Работа делится по границам бакетов: задача получает подряд идущие бакеты целиком,
+// поэтому два потока никогда не пишут в один бакет и не делят его кэш-линии
+// (кроме крайних линий соседних бакетов, если аллокатор положил их вплотную).
+
+class DequeThreadPool {
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex              mutex;
+    std::condition_variable wake;      // workers ждут новую порцию задач
+    std::condition_variable finished;  // run() ждет, пока workers выйдут из порции
+    size_t generation = 0;
+    size_t busy       = 0;  // workers, еще не вышедшие из текущей порции
+    bool   stopping   = false;
+
+    // текущая порция: задачи [0, task_count) раздаются через next_task
+    void (*job)(void*, size_t) = nullptr;
+    void*  job_ctx    = nullptr;
+    size_t task_count = 0;
+    std::atomic<size_t> next_task{0};
+    std::exception_ptr  error;
+
+    void work_loop();
+    void drain();
+
+public:
+    // threads - число потоков вместе с вызывающим; 0 - по числу ядер
+    explicit DequeThreadPool(size_t threads = 0);
+    DequeThreadPool(const DequeThreadPool&) = delete;
+    DequeThreadPool& operator=(const DequeThreadPool&) = delete;
+    ~DequeThreadPool();
+
+    size_t size() const {
+        return workers.size() + 1;
+    }
+
+    // f(i) для каждого i из [0, tasks); возвращает управление, когда выполнены все задачи.
+    // Первое исключение из f пробрасывается после завершения порции, оставшиеся задачи пропускаются.
+    // Порции идут по одной: run() нельзя вызывать одновременно из разных потоков и из самих задач.
+    template <typename F>
+    void run(size_t tasks, F&& f);
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+inline void DequeThreadPool::drain() {
+    for (size_t i = next_task.fetch_add(1, std::memory_order_relaxed); i < task_count;
+         i = next_task.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            job(job_ctx, i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next_task.store(task_count, std::memory_order_relaxed);
+        }
+    }
+}
+
+inline void DequeThreadPool::work_loop() {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        drain();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+inline DequeThreadPool::DequeThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back([this] { work_loop(); });
+    }
+}
+
+inline DequeThreadPool::~DequeThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <typename F>
+void DequeThreadPool::run(size_t tasks, F&& f) {
+    if (tasks == 0) return;
+    if (workers.empty() || tasks == 1) {
+        for (size_t i = 0; i < tasks; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    using Fn = std::remove_reference_t<F>;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job        = [](void* ctx, size_t i) { (*static_cast<Fn*>(ctx))(i); };
+        job_ctx    = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        task_count = tasks;
+        next_task.store(0, std::memory_order_relaxed);
+        error = nullptr;
+        busy  = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+    drain();
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return busy == 0; });
+        failure = std::move(error);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+
+namespace deque_parallel_detail {
+
+// непрерывный кусок одного бакета и индекс его первого элемента в деке
+template <typename Ptr>
+struct segment {
+    Ptr    first;
+    Ptr    last;
+    size_t offset;
+};
+
+template <typename D>
+auto collect_segments(D& deq) {
+    using Ptr = std::conditional_t<std::is_const<D>::value, const typename D::value_type*, typename D::value_type*>;
+    std::vector<segment<Ptr>> segments;
+    size_t offset = 0;
+    deq.for_each_segment([&](Ptr first, Ptr last) {
+        segments.push_back({first, last, offset});
+        offset += last - first;
+    });
+    return segments;
+}
+
+// делит segments на не больше parts групп подряд идущих бакетов примерно поровну по элементам;
+// группа g - это segments[bounds[g], bounds[g + 1])
+template <typename Segment>
+std::vector<size_t> split_segments(const std::vector<Segment>& segments, size_t total, size_t parts) {
+    std::vector<size_t> bounds(1, 0);
+    parts = std::max<size_t>(1, std::min(parts, segments.size()));
+    for (size_t g = 1; g < parts; ++g) {
+        // первая граница бакета не раньше g / parts всех элементов
+        size_t target = total / parts * g + total % parts * g / parts;
+        size_t b = bounds.back();
+        while (b < segments.size() && segments[b].offset < target) ++b;
+        if (b > bounds.back() && b < segments.size()) {
+            bounds.push_back(b);
+        }
+    }
+    bounds.push_back(segments.size());
+    return bounds;
+}
+
+// по несколько задач на поток, чтобы неравные по стоимости группы выровнялись
+constexpr size_t tasks_per_thread = 4;
+
+template <typename D, typename F>
+void for_each_group(DequeThreadPool& pool, D& deq, size_t parts, F&& f) {
+    auto segments = collect_segments(deq);
+    auto bounds   = split_segments(segments, deq.size(), parts);
+    pool.run(bounds.size() - 1, [&](size_t g) {
+        for (size_t s = bounds[g]; s < bounds[g + 1]; ++s) {
+            f(segments[s]);
+        }
+    });
+}
+
+} // namespace deque_parallel_detail
+
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename UnaryFunction>
+void for_each(DequeThreadPool& pool, Deque<T, BucketSize, Allocator, Stats>& deq, UnaryFunction f) {
+    deque_parallel_detail::for_each_group(pool, deq, pool.size() * deque_parallel_detail::tasks_per_thread, [&f](const auto& seg) {
+        std::for_each(seg.first, seg.last, f);
+    });
+}
+
+// преобразование на месте
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename UnaryOp>
+void transform(DequeThreadPool& pool, Deque<T, BucketSize, Allocator, Stats>& deq, UnaryOp op) {
+    deque_parallel_detail::for_each_group(pool, deq, pool.size() * deque_parallel_detail::tasks_per_thread, [&op](const auto& seg) {
+        std::transform(seg.first, seg.last, seg.first, op);
+    });
+}
+
+// out - итератор произвольного доступа на начало диапазона размером deq.size()
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename RandomIt, typename UnaryOp>
+RandomIt transform(DequeThreadPool& pool, const Deque<T, BucketSize, Allocator, Stats>& deq, RandomIt out, UnaryOp op) {
+    static_assert(std::is_convertible<typename std::iterator_traits<RandomIt>::iterator_category, std::random_access_iterator_tag>::value,
+                  "transform: parallel output must be a random access iterator");
+    deque_parallel_detail::for_each_group(pool, deq, pool.size() * deque_parallel_detail::tasks_per_thread, [&out, &op](const auto& seg) {
+        std::transform(seg.first, seg.last, out + seg.offset, op);
+    });
+    return out + deq.size();
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename RandomIt>
+RandomIt copy(DequeThreadPool& pool, const Deque<T, BucketSize, Allocator, Stats>& deq, RandomIt out) {
+    static_assert(std::is_convertible<typename std::iterator_traits<RandomIt>::iterator_category, std::random_access_iterator_tag>::value,
+                  "copy: parallel output must be a random access iterator");
+    deque_parallel_detail::for_each_group(pool, deq, pool.size() * deque_parallel_detail::tasks_per_thread, [&out](const auto& seg) {
+        std::copy(seg.first, seg.last, out + seg.offset);
+    });
+    return out + deq.size();
+}
+
+// как std::reduce: op должна быть ассоциативной и коммутативной, порядок свертки не задан
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename Init, typename BinaryOp>
+Init reduce(DequeThreadPool& pool, const Deque<T, BucketSize, Allocator, Stats>& deq, Init init, BinaryOp op) {
+    // частичные результаты групп лежат в разных кэш-линиях
+    struct alignas(64) partial {
+        std::optional<Init> value;
+    };
+    auto segments = deque_parallel_detail::collect_segments(deq);
+    auto bounds   = deque_parallel_detail::split_segments(segments, deq.size(), pool.size() * deque_parallel_detail::tasks_per_thread);
+    std::vector<partial> partials(bounds.size() - 1);
+
+    pool.run(bounds.size() - 1, [&](size_t g) {
+        std::optional<Init>& acc = partials[g].value;
+        for (size_t s = bounds[g]; s < bounds[g + 1]; ++s) {
+            const T* first = segments[s].first;
+            if (!acc) {
+                acc.emplace(*first++);
+            }
+            *acc = std::accumulate(first, segments[s].last, std::move(*acc), op);
+        }
+    });
+    for (partial& p : partials) {
+        if (p.value) {
+            init = op(std::move(init), std::move(*p.value));
+        }
+    }
+    return init;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename Init>
+Init reduce(DequeThreadPool& pool, const Deque<T, BucketSize, Allocator, Stats>& deq, Init init) {
+    return reduce(pool, deq, std::move(init), std::plus<>());
+}
+
+// Каждая группа бакетов сортируется своим потоком, затем соседние группы попарно
+// сливаются std::inplace_merge; слияния одного раунда идут параллельно, раундов log2(групп).
+template <typename T, size_t BucketSize, typename Allocator, typename Stats, typename Compare>
+void sort(DequeThreadPool& pool, Deque<T, BucketSize, Allocator, Stats>& deq, Compare comp) {
+    auto segments = deque_parallel_detail::collect_segments(deq);
+    auto bounds   = deque_parallel_detail::split_segments(segments, deq.size(), pool.size());
+
+    // границы групп в индексах элементов
+    std::vector<size_t> runs;
+    for (size_t b : bounds) {
+        runs.push_back(b < segments.size() ? segments[b].offset : deq.size());
+    }
+
+    auto begin = deq.begin();
+    pool.run(runs.size() - 1, [&](size_t g) {
+        std::sort(begin + runs[g], begin + runs[g + 1], comp);
+    });
+    for (size_t width = 1; width < runs.size() - 1; width *= 2) {
+        size_t merges = (runs.size() - 1 + 2 * width - 1) / (2 * width);
+        pool.run(merges, [&](size_t m) {
+            size_t lo  = m * 2 * width;
+            size_t mid = std::min(lo + width, runs.size() - 1);
+            size_t hi  = std::min(lo + 2 * width, runs.size() - 1);
+            if (mid < hi) {
+                std::inplace_merge(begin + runs[lo], begin + runs[mid], begin + runs[hi], comp);
+            }
+        });
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void sort(DequeThreadPool& pool, Deque<T, BucketSize, Allocator, Stats>& deq) {
+    sort(pool, deq, std::less<>());
+}
+
+#endif /* DEQUE_PARALLEL_H */
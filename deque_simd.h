@@ -0,0 +1,375 @@
+#ifndef DEQUE_SIMD_H
+#define DEQUE_SIMD_H
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "my_deque.h"
+
+// Векторные ядра для Deque арифметических типов: sum, min/max, count, find и scale_add.
+// Ядра работают прямо по памяти бакетов (через for_each_segment), поэтому вектор
+// не рвется на границе каждого элемента, как при обходе через common_iterator.
+//
+// Реализация на векторных расширениях GCC/Clang: одна и та же функция-ядро собирается
+// под SSE2 (базовый x86-64, 16 байт) и под AVX2+FMA (32 байта), нужная версия выбирается
+// во время выполнения. На других архитектурах используется 16-байтная версия
+// (NEON и т.п.), без векторных расширений - скалярные циклы.
+
+#if defined(__GNUC__)
+#define DEQUE_SIMD_VECTOR 1
+#if defined(__x86_64__) || defined(__i386__)
+#define DEQUE_SIMD_X86 1
+#endif
+#endif
+
+namespace deque_simd_detail {
+
+// тип суммы: целые расширяются до 64 бит, float суммируется в double
+template <typename T>
+using sum_t = std::conditional_t<std::is_floating_point<T>::value, double,
+              std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+
+// типы, для которых есть векторные ядра
+template <typename T>
+struct is_vectorizable
+    : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                   !std::is_same<T, long double>::value> {};
+
+#ifdef DEQUE_SIMD_X86
+inline bool has_avx2() {
+    static const bool value = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return value;
+}
+#endif
+
+// Скалярные версии --------------------------------------------------------------------------/
+template <typename T>
+sum_t<T> sum_scalar(const T* p, size_t n) {
+    sum_t<T> s = 0;
+    for (size_t i = 0; i < n; ++i) s += p[i];
+    return s;
+}
+
+template <typename T>
+T min_scalar(const T* p, size_t n, T m) {
+    for (size_t i = 0; i < n; ++i) m = p[i] < m ? p[i] : m;
+    return m;
+}
+
+template <typename T>
+T max_scalar(const T* p, size_t n, T m) {
+    for (size_t i = 0; i < n; ++i) m = m < p[i] ? p[i] : m;
+    return m;
+}
+
+template <typename T>
+size_t count_scalar(const T* p, size_t n, T value) {
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i) c += p[i] == value;
+    return c;
+}
+
+template <typename T>
+size_t find_scalar(const T* p, size_t n, T value) {
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] == value) return i;
+    }
+    return n;
+}
+
+// знаковые целые считаем в беззнаковых: переполнение то же, но без UB; для short и char
+// к тому же нужен хотя бы unsigned, иначе произведение повышается до знакового int
+template <typename T>
+using scale_add_unsigned = typename std::conditional_t<std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                                                       std::make_unsigned<T>, std::common_type<T>>::type;
+
+template <typename T>
+void scale_add_scalar(T* p, size_t n, T a, T b) {
+    using U = scale_add_unsigned<T>;
+    using W = std::common_type_t<U, unsigned>;
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<T>(W(U(p[i])) * W(U(a)) + W(U(b)));
+}
+
+#ifdef DEQUE_SIMD_VECTOR
+// Векторные версии: Bytes - ширина регистра ------------------------------------------------/
+template <typename T, size_t Bytes>
+struct vec {
+    typedef T type __attribute__((vector_size(Bytes)));
+    static constexpr size_t lanes = Bytes / sizeof(T);
+};
+
+// через ссылку, а не возвратом: 32-байтный вектор по значению меняет ABI без -mavx
+template <typename V, typename T>
+__attribute__((always_inline)) inline void load(V& v, const T* p) {
+    std::memcpy(&v, p, sizeof(v));
+}
+
+template <typename T, size_t Bytes>
+__attribute__((always_inline)) inline sum_t<T> sum_kernel(const T* p, size_t n) {
+    using W  = sum_t<T>;
+    using VW = typename vec<W, Bytes>::type;
+    constexpr size_t L = vec<W, Bytes>::lanes;
+    using VT = typename vec<T, L * sizeof(T)>::type;
+
+    VW acc0 = {}, acc1 = {};
+    size_t i = 0;
+    for ( ; i + 2 * L <= n; i += 2 * L) {
+        VT v0, v1;
+        load(v0, p + i);
+        load(v1, p + i + L);
+        acc0 += __builtin_convertvector(v0, VW);
+        acc1 += __builtin_convertvector(v1, VW);
+    }
+    acc0 += acc1;
+    W s = 0;
+    for (size_t k = 0; k < L; ++k) s += acc0[k];
+    return s + sum_scalar(p + i, n - i);
+}
+
+template <typename T, size_t Bytes, bool IsMin>
+__attribute__((always_inline)) inline T minmax_kernel(const T* p, size_t n, T m) {
+    using V = typename vec<T, Bytes>::type;
+    constexpr size_t L = vec<T, Bytes>::lanes;
+
+    V acc = V{} + m;
+    size_t i = 0;
+    for ( ; i + L <= n; i += L) {
+        V v;
+        load(v, p + i);
+        acc = IsMin ? (v < acc ? v : acc) : (acc < v ? v : acc);
+    }
+    for (size_t k = 0; k < L; ++k) {
+        m = IsMin ? (acc[k] < m ? acc[k] : m) : (m < acc[k] ? acc[k] : m);
+    }
+    return IsMin ? min_scalar(p + i, n - i, m) : max_scalar(p + i, n - i, m);
+}
+
+template <typename T, size_t Bytes>
+__attribute__((always_inline)) inline size_t count_kernel(const T* p, size_t n, T value) {
+    using V = typename vec<T, Bytes>::type;
+    using M = decltype(V{} == V{});
+    using Lane = std::remove_reference_t<decltype(M{}[0])>;
+    constexpr size_t L = vec<T, Bytes>::lanes;
+    // счетчики в дорожках не должны переполниться: сбрасываем их каждые max_iter шагов
+    constexpr size_t max_iter = static_cast<size_t>(std::numeric_limits<Lane>::max());
+
+    V needle = V{} + value;
+    size_t c = 0;
+    size_t i = 0;
+    while (i + L <= n) {
+        M acc = {};
+        for (size_t step = 0; step < max_iter && i + L <= n; ++step, i += L) {
+            V v;
+            load(v, p + i);
+            acc -= (v == needle); // совпадение дает -1
+        }
+        for (size_t k = 0; k < L; ++k) c += static_cast<size_t>(acc[k]);
+    }
+    return c + count_scalar(p + i, n - i, value);
+}
+
+template <typename T, size_t Bytes>
+__attribute__((always_inline)) inline size_t find_kernel(const T* p, size_t n, T value) {
+    using V = typename vec<T, Bytes>::type;
+    using M = decltype(V{} == V{});
+    constexpr size_t L = vec<T, Bytes>::lanes;
+
+    V needle = V{} + value;
+    size_t i = 0;
+    for ( ; i + L <= n; i += L) {
+        V v;
+        load(v, p + i);
+        M hit = (v == needle);
+        bool any = false;
+        for (size_t k = 0; k < L; ++k) any |= hit[k] != 0;
+        if (any) break;
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+template <typename T, size_t Bytes>
+__attribute__((always_inline)) inline void scale_add_kernel(T* p, size_t n, T a, T b) {
+    // знаковые целые считаем в беззнаковых дорожках, как и scale_add_scalar для хвоста
+    using U = scale_add_unsigned<T>;
+    using V = typename vec<U, Bytes>::type;
+    constexpr size_t L = vec<U, Bytes>::lanes;
+
+    V va = V{} + static_cast<U>(a);
+    V vb = V{} + static_cast<U>(b);
+    size_t i = 0;
+    for ( ; i + L <= n; i += L) {
+        V v;
+        load(v, p + i);
+        v = v * va + vb;
+        std::memcpy(p + i, &v, sizeof(v));
+    }
+    scale_add_scalar(p + i, n - i, a, b);
+}
+
+#ifdef DEQUE_SIMD_X86
+template <typename T>
+__attribute__((target("avx2,fma"))) sum_t<T> sum_avx2(const T* p, size_t n) {
+    return sum_kernel<T, 32>(p, n);
+}
+
+template <typename T, bool IsMin>
+__attribute__((target("avx2,fma"))) T minmax_avx2(const T* p, size_t n, T m) {
+    return minmax_kernel<T, 32, IsMin>(p, n, m);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) size_t count_avx2(const T* p, size_t n, T value) {
+    return count_kernel<T, 32>(p, n, value);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) size_t find_avx2(const T* p, size_t n, T value) {
+    return find_kernel<T, 32>(p, n, value);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) void scale_add_avx2(T* p, size_t n, T a, T b) {
+    scale_add_kernel<T, 32>(p, n, a, b);
+}
+#endif /* DEQUE_SIMD_X86 */
+#endif /* DEQUE_SIMD_VECTOR */
+
+// Диспетчеризация для одного непрерывного куска ------------------------------------------/
+template <typename T>
+sum_t<T> sum(const T* p, size_t n) {
+#ifdef DEQUE_SIMD_VECTOR
+    if constexpr (is_vectorizable<T>::value) {
+#ifdef DEQUE_SIMD_X86
+        if (has_avx2()) return sum_avx2(p, n);
+#endif
+        return sum_kernel<T, 16>(p, n);
+    }
+#endif
+    return sum_scalar(p, n);
+}
+
+template <typename T, bool IsMin>
+T minmax(const T* p, size_t n, T m) {
+#ifdef DEQUE_SIMD_VECTOR
+    if constexpr (is_vectorizable<T>::value) {
+#ifdef DEQUE_SIMD_X86
+        if (has_avx2()) return minmax_avx2<T, IsMin>(p, n, m);
+#endif
+        return minmax_kernel<T, 16, IsMin>(p, n, m);
+    }
+#endif
+    return IsMin ? min_scalar(p, n, m) : max_scalar(p, n, m);
+}
+
+template <typename T>
+size_t count(const T* p, size_t n, T value) {
+#ifdef DEQUE_SIMD_VECTOR
+    if constexpr (is_vectorizable<T>::value) {
+#ifdef DEQUE_SIMD_X86
+        if (has_avx2()) return count_avx2(p, n, value);
+#endif
+        return count_kernel<T, 16>(p, n, value);
+    }
+#endif
+    return count_scalar(p, n, value);
+}
+
+template <typename T>
+size_t find(const T* p, size_t n, T value) {
+#ifdef DEQUE_SIMD_VECTOR
+    if constexpr (is_vectorizable<T>::value) {
+#ifdef DEQUE_SIMD_X86
+        if (has_avx2()) return find_avx2(p, n, value);
+#endif
+        return find_kernel<T, 16>(p, n, value);
+    }
+#endif
+    return find_scalar(p, n, value);
+}
+
+template <typename T>
+void scale_add(T* p, size_t n, T a, T b) {
+#ifdef DEQUE_SIMD_VECTOR
+    if constexpr (is_vectorizable<T>::value) {
+#ifdef DEQUE_SIMD_X86
+        if (has_avx2()) return scale_add_avx2(p, n, a, b);
+#endif
+        return scale_add_kernel<T, 16>(p, n, a, b);
+    }
+#endif
+    scale_add_scalar(p, n, a, b);
+}
+
+} // namespace deque_simd_detail
+
+
+// Сумма всех элементов; целые суммируются в 64 бита, float - в double
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+deque_simd_detail::sum_t<T> simd_sum(const Deque<T, BucketSize, Allocator, Stats>& deq) {
+    static_assert(std::is_arithmetic<T>::value, "simd_sum: T must be arithmetic");
+    deque_simd_detail::sum_t<T> s = 0;
+    deq.for_each_segment([&s](const T* first, const T* last) {
+        s += deque_simd_detail::sum(first, last - first);
+    });
+    return s;
+}
+
+// Минимум; для пустого дека - std::numeric_limits<T>::max()
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T simd_min(const Deque<T, BucketSize, Allocator, Stats>& deq) {
+    static_assert(std::is_arithmetic<T>::value, "simd_min: T must be arithmetic");
+    T m = std::numeric_limits<T>::max();
+    deq.for_each_segment([&m](const T* first, const T* last) {
+        m = deque_simd_detail::minmax<T, true>(first, last - first, m);
+    });
+    return m;
+}
+
+// Максимум; для пустого дека - std::numeric_limits<T>::lowest()
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T simd_max(const Deque<T, BucketSize, Allocator, Stats>& deq) {
+    static_assert(std::is_arithmetic<T>::value, "simd_max: T must be arithmetic");
+    T m = std::numeric_limits<T>::lowest();
+    deq.for_each_segment([&m](const T* first, const T* last) {
+        m = deque_simd_detail::minmax<T, false>(first, last - first, m);
+    });
+    return m;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t simd_count(const Deque<T, BucketSize, Allocator, Stats>& deq, T value) {
+    static_assert(std::is_arithmetic<T>::value, "simd_count: T must be arithmetic");
+    size_t c = 0;
+    deq.for_each_segment([&c, value](const T* first, const T* last) {
+        c += deque_simd_detail::count(first, last - first, value);
+    });
+    return c;
+}
+
+// Индекс первого элемента, равного value, или size(), если такого нет
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t simd_find(const Deque<T, BucketSize, Allocator, Stats>& deq, T value) {
+    static_assert(std::is_arithmetic<T>::value, "simd_find: T must be arithmetic");
+    size_t index = 0;
+    deq.for_each_segment([&index, value](const T* first, const T* last) {
+        size_t n   = last - first;
+        size_t pos = deque_simd_detail::find(first, n, value);
+        index += pos;
+        return pos == n;
+    });
+    return index;
+}
+
+// На месте: x = x * a + b для каждого элемента
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void simd_scale_add(Deque<T, BucketSize, Allocator, Stats>& deq, T a, T b) {
+    static_assert(std::is_arithmetic<T>::value, "simd_scale_add: T must be arithmetic");
+    deq.for_each_segment([a, b](T* first, T* last) {
+        deque_simd_detail::scale_add(first, last - first, a, b);
+    });
+}
+
+#endif /* DEQUE_SIMD_H */
@@ -0,0 +1,284 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Ограниченная очередь для многих производителей и многих потребителей (по схеме Вьюкова,
+// вариант с билетами). Хранилище - бакеты по bucket_size слотов, как в Deque, все заводятся
+// в конструкторе; емкость округляется вверх до степени двойки (и не меньше одного бакета).
+//
+// У каждого слота есть счетчик turn. Билет t (номер операции) попадает в слот t & mask на круге
+// round = t / capacity:
+//   - производитель ждет turn == 2 * round, строит элемент и публикует turn = 2 * round + 1;
+//   - потребитель ждет turn == 2 * round + 1, забирает элемент и отдает слот: turn = 2 * round + 2.
+// push/pop берут билет через fetch_add и ждут своей очереди в слоте; try_push/try_pop
+// смотрят на слот заранее и забирают билет CAS-ом, только если ждать не придется.
+// Потоки встречаются только на head (потребители), tail (производители) и на своем слоте;
+// head и tail разнесены по разным кэш-линиям. Сами слоты упакованы плотно, как элементы в бакете
+// Deque, так что соседние билеты могут делить кэш-линию.
+//
+// Билет нельзя вернуть, поэтому конструктор T и перемещение из слота не должны бросать.
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Allocator = std::allocator<T>>
+class MpmcQueue {
+private:
+    static_assert(BucketSize > 0, "MpmcQueue: bucket size must be positive");
+    static_assert(std::is_nothrow_destructible<T>::value, "MpmcQueue: T must be nothrow destructible");
+    static_assert(std::is_nothrow_move_assignable<T>::value, "MpmcQueue: T must be nothrow move assignable");
+
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    static constexpr size_t cache_line = 64;
+    // столько раз проверяем слот подряд, потом уступаем процессор
+    static constexpr unsigned spin_limit = 64;
+
+    struct slot {
+        std::atomic<size_t> turn{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* get() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using alloc_traits       = std::allocator_traits<Allocator>;
+    using slot_allocator     = typename alloc_traits::template rebind_alloc<slot>;
+    using slot_alloc_traits  = std::allocator_traits<slot_allocator>;
+    using map_allocator      = typename alloc_traits::template rebind_alloc<slot*>;
+
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value, "MpmcQueue: Allocator::value_type must be T");
+
+    // поля потребителей
+    alignas(cache_line) std::atomic<size_t> head;
+    // поля производителей
+    alignas(cache_line) std::atomic<size_t> tail;
+
+    // после конструктора только читаются
+    alignas(cache_line) Allocator alloc;
+    std::vector<slot*, map_allocator> buckets;
+    size_t capacity_mask;
+    size_t capacity_shift;
+
+    slot& at(size_t ticket) {
+        size_t i = ticket & capacity_mask;
+        return buckets[i >> bucket_shift][i & bucket_mask];
+    }
+
+    size_t round(size_t ticket) const {
+        return ticket >> capacity_shift;
+    }
+
+    static void wait_turn(const std::atomic<size_t>& turn, size_t expected);
+
+public:
+    using value_type     = T;
+    using allocator_type = Allocator;
+    using size_type      = size_t;
+
+    explicit MpmcQueue(size_t capacity, const Allocator& allocator = Allocator());
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    ~MpmcQueue();
+
+    // Ждут свободного слота
+    void push(const T& value);
+    void push(T&& value);
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    // false, если очередь заполнена
+    bool try_push(const T& value);
+    bool try_push(T&& value);
+    template <typename... Args>
+    bool try_emplace(Args&&... args);
+
+    // Ждет элемента
+    void pop(T& out);
+    // false, если очередь пуста
+    bool try_pop(T& out);
+
+    size_t capacity() const;
+    // Приблизительные значения, пока с очередью работают другие потоки
+    size_t size_approx() const;
+    bool empty_approx() const;
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+void MpmcQueue<T, BucketSize, Allocator>::wait_turn(const std::atomic<size_t>& turn, size_t expected) {
+    for (unsigned spins = 0; turn.load(std::memory_order_acquire) != expected; ++spins) {
+        if (spins >= spin_limit) {
+            // владелец предыдущего билета на этом слоте мог быть вытеснен с процессора
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+MpmcQueue<T, BucketSize, Allocator>::MpmcQueue(size_t capacity, const Allocator& allocator)
+    : head(0), tail(0), alloc(allocator), buckets(map_allocator(alloc)) {
+    size_t slots   = std::max(deque_detail::round_up_pow2(capacity), bucket_size);
+    capacity_mask  = slots - 1;
+    capacity_shift = deque_detail::log2_pow2(slots);
+
+    slot_allocator slot_alloc(alloc);
+    buckets.reserve(slots >> bucket_shift);
+    try {
+        for (size_t b = 0; b < (slots >> bucket_shift); ++b) {
+            slot* bucket = slot_alloc_traits::allocate(slot_alloc, bucket_size);
+            for (size_t i = 0; i < bucket_size; ++i) {
+                ::new (static_cast<void*>(bucket + i)) slot();
+            }
+            buckets.push_back(bucket);
+        }
+    }
+    catch (...) {
+        for (slot* bucket : buckets) {
+            slot_alloc_traits::deallocate(slot_alloc, bucket, bucket_size);
+        }
+        throw;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+MpmcQueue<T, BucketSize, Allocator>::~MpmcQueue() {
+    // к деструктору все операции закончены: живые элементы - билеты [head, tail)
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_relaxed);
+    for ( ; h < t; ++h) {
+        alloc_traits::destroy(alloc, at(h).get());
+    }
+    slot_allocator slot_alloc(alloc);
+    for (slot* bucket : buckets) {
+        for (size_t i = 0; i < bucket_size; ++i) {
+            bucket[i].~slot();
+        }
+        slot_alloc_traits::deallocate(slot_alloc, bucket, bucket_size);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void MpmcQueue<T, BucketSize, Allocator>::push(const T& value) {
+    emplace(value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void MpmcQueue<T, BucketSize, Allocator>::push(T&& value) {
+    emplace(std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+template <typename... Args>
+void MpmcQueue<T, BucketSize, Allocator>::emplace(Args&&... args) {
+    static_assert(std::is_nothrow_constructible<T, Args&&...>::value, "emplace(): constructor must not throw");
+    size_t ticket = tail.fetch_add(1, std::memory_order_relaxed);
+    slot& s       = at(ticket);
+    wait_turn(s.turn, 2 * round(ticket));
+    alloc_traits::construct(alloc, reinterpret_cast<T*>(s.storage), std::forward<Args>(args)...);
+    s.turn.store(2 * round(ticket) + 1, std::memory_order_release);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool MpmcQueue<T, BucketSize, Allocator>::try_push(const T& value) {
+    return try_emplace(value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool MpmcQueue<T, BucketSize, Allocator>::try_push(T&& value) {
+    return try_emplace(std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+template <typename... Args>
+bool MpmcQueue<T, BucketSize, Allocator>::try_emplace(Args&&... args) {
+    static_assert(std::is_nothrow_constructible<T, Args&&...>::value, "try_emplace(): constructor must not throw");
+    size_t ticket = tail.load(std::memory_order_relaxed);
+    for (;;) {
+        slot& s = at(ticket);
+        if (s.turn.load(std::memory_order_acquire) == 2 * round(ticket)) {
+            // слот свободен для этого круга: билет наш, если его не взял другой производитель
+            if (tail.compare_exchange_strong(ticket, ticket + 1, std::memory_order_relaxed)) {
+                alloc_traits::construct(alloc, reinterpret_cast<T*>(s.storage), std::forward<Args>(args)...);
+                s.turn.store(2 * round(ticket) + 1, std::memory_order_release);
+                return true;
+            }
+        } else {
+            // слот занят элементом прошлого круга; если tail не сдвинулся, очередь заполнена
+            size_t prev = ticket;
+            ticket = tail.load(std::memory_order_relaxed);
+            if (ticket == prev) {
+                return false;
+            }
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void MpmcQueue<T, BucketSize, Allocator>::pop(T& out) {
+    size_t ticket = head.fetch_add(1, std::memory_order_relaxed);
+    slot& s       = at(ticket);
+    wait_turn(s.turn, 2 * round(ticket) + 1);
+    out = std::move(*s.get());
+    alloc_traits::destroy(alloc, s.get());
+    s.turn.store(2 * round(ticket) + 2, std::memory_order_release);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool MpmcQueue<T, BucketSize, Allocator>::try_pop(T& out) {
+    size_t ticket = head.load(std::memory_order_relaxed);
+    for (;;) {
+        slot& s = at(ticket);
+        if (s.turn.load(std::memory_order_acquire) == 2 * round(ticket) + 1) {
+            if (head.compare_exchange_strong(ticket, ticket + 1, std::memory_order_relaxed)) {
+                out = std::move(*s.get());
+                alloc_traits::destroy(alloc, s.get());
+                s.turn.store(2 * round(ticket) + 2, std::memory_order_release);
+                return true;
+            }
+        } else {
+            size_t prev = ticket;
+            ticket = head.load(std::memory_order_relaxed);
+            if (ticket == prev) {
+                return false;
+            }
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t MpmcQueue<T, BucketSize, Allocator>::capacity() const {
+    return capacity_mask + 1;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t MpmcQueue<T, BucketSize, Allocator>::size_approx() const {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_relaxed);
+    // ждущие pop уже взяли билеты, и head может обогнать tail
+    return t > h ? t - h : 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool MpmcQueue<T, BucketSize, Allocator>::empty_approx() const {
+    return size_approx() == 0;
+}
+
+#endif /* MPMC_QUEUE_H */
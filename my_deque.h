@@ -1,687 +1,2321 @@
-#ifndef DEQUE_H
-#define DEQUE_H
-
-#ifdef _DEBUG
-#include <iostream>
-#endif /* _DEBUG */
-
-#include <vector>
-#include <utility>
-#include <type_traits>
-#include <iterator>
-#include <stdexcept>
-#include <stddef.h>
-#include <stdint.h>
-
-
-template <typename T>
-class Deque {
-private:
-    static constexpr size_t bucket_size = 10;
-
-    std::vector<T*> arr;
-    size_t bucket_count;
-    size_t sz;
-    size_t cap;
-    std::pair<int, int> begin_pos;
-    std::pair<int, int> end_pos;
-
-    std::pair<int, int> pos_calc(const std::pair<int, int>& pos, size_t offset) const;
-    void pos_forward(std::pair<int, int>& pos);
-    void pos_back(std::pair<int, int>& pos);
-
-    void expand_back(size_t n = 2);
-    void expand_front(size_t n = 2);
-
-    bool is_index_in_range(int i, int j) const;
-    bool is_index_in_range(const std::pair<int, int>& val) const;
-
-    template <bool IsConst>
-    class common_iterator {
-    private:
-        using ConditionalArr  = std::conditional_t<IsConst, const std::vector<T*>, std::vector<T*>>;
-        using ConditionalPtr  = std::conditional_t<IsConst, const T*, T*>;
-        using ConditionalRef  = std::conditional_t<IsConst, const T&, T&>;
-        using ConditionalType = std::conditional_t<IsConst, const T, T>;
-
-        std::pair<int, int> it_pos;
-        ConditionalPtr      it_ptr;
-        ConditionalArr&     arr_ref;
-
-        void pos_calc(std::pair<int, int>& pos, size_t offset) const {
-            size_t begin = pos.first * bucket_size + pos.second;
-            size_t val   = begin + offset;
-            pos.first    = val / bucket_size;
-            pos.second   = val % bucket_size;
-        }
-
-    public:
-        using iterator_category      = std::random_access_iterator_tag;
-        using difference_type        = std::ptrdiff_t;
-        using value_type             = ConditionalType;
-        using pointer                = ConditionalPtr;
-        using reference              = ConditionalRef;    
-
-        common_iterator(ConditionalArr& arr, const std::pair<int, int>& pos) 
-        : it_pos(pos), it_ptr(arr[pos.first] + pos.second), arr_ref(arr) {};
-
-        common_iterator& operator++() {
-            if (it_pos.second < bucket_size - 1) {
-                ++it_pos.second;
-                ++it_ptr;
-            } else {
-                ++it_pos.first;
-                it_pos.second = 0;
-                it_ptr = arr_ref[it_pos.first] + it_pos.second;
-            }
-            return *this;
-        }
-        
-        common_iterator& operator--() {
-            if (it_pos.second > 0) {
-                --it_pos.second;
-                --it_ptr;
-            } else {
-                --it_pos.first;
-                it_pos.second = bucket_size - 1;
-                it_ptr = arr_ref[it_pos.first] + it_pos.second;
-            }
-            return *this;
-        }
-
-        common_iterator operator++(int) {
-            common_iterator old = *this;
-            ++(*this);
-            return old;
-        }
-        
-        common_iterator operator--(int) {
-            common_iterator old = *this;
-            --(*this);
-            return old;
-        }
-
-        common_iterator& operator+=(difference_type n) {
-            pos_calc(it_pos, n);
-            it_ptr = arr_ref[it_pos.first] + it_pos.second;
-            return *this;
-        }
-
-        common_iterator& operator-=(difference_type n) {
-            pos_calc(it_pos, -n);
-            it_ptr = arr_ref[it_pos.first] + it_pos.second;
-            return *this;
-        }
-
-        common_iterator operator+(difference_type n) const {
-            common_iterator tmp = *this;
-            pos_calc(tmp.it_pos, n);
-            tmp.it_ptr = arr_ref[tmp.it_pos.first] + tmp.it_pos.second;
-            return tmp;
-        }
-
-        common_iterator operator-(difference_type n) const {
-            common_iterator tmp = *this;
-            pos_calc(tmp.it_pos, -n);
-            tmp.it_ptr = arr_ref[tmp.it_pos.first] + tmp.it_pos.second;
-            return tmp;
-        }
-
-        bool operator<(const common_iterator<IsConst>& other) const {
-            return it_pos < other.it_pos;
-        }
-
-        bool operator<=(const common_iterator<IsConst>& other) const {
-            return it_pos <= other.it_pos;
-        }
-
-        bool operator>=(const common_iterator<IsConst>& other) const {
-            return it_pos >= other.it_pos;
-        }
-
-        bool operator>(const common_iterator<IsConst>& other) const {
-            return it_pos > other.it_pos;
-        }
-
-        bool operator==(const common_iterator<IsConst>& other) const {
-            return it_pos == other.it_pos;
-        }
-
-        bool operator!=(const common_iterator<IsConst>& other) const {
-            return it_pos != other.it_pos;
-        }
-
-        difference_type operator-(const common_iterator<IsConst>& other) const {
-            return (it_pos.first - other.it_pos.first) * bucket_size + (it_pos.second - other.it_pos.second);
-        }
-
-        ConditionalRef operator*() {
-            return *it_ptr;
-        }
-
-        ConditionalPtr operator->() {
-            return it_ptr;
-        }
-    };
-public:
-    using iterator               = common_iterator<false>;
-    using const_iterator         = common_iterator<true>;
-    using reverse_iterator       = std::reverse_iterator<iterator>;
-    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-
-    Deque();
-    explicit Deque(const Deque<T>& other);
-    Deque(int n, const T& value = T());
-    Deque(Deque<T>&& other) noexcept;
-    ~Deque();
-
-    Deque<T>& operator=(const Deque<T>& other);
-    Deque<T>& operator=(Deque<T>&& other) noexcept;
-
-    T& operator[](size_t index);
-    const T& operator[](size_t index) const;
-
-    T& at(size_t index);
-    const T& at(size_t index) const;
-
-    size_t size() const;
-    size_t capacity() const;
-
-    void push_back(const T& value = T());
-    void push_back(T&& value);
-
-    void push_front(const T& value = T());
-    void push_front(T&& value);
-
-    void pop_back();
-    void pop_front();
-
-    void insert(iterator iter, const T& value);
-
-    template <typename... Args>
-    iterator emplace(iterator iter, Args&&... args);
-    template <typename... Args>
-    void emplace_back(Args&&... args);
-    template <typename... Args>
-    void emplace_front(Args&&... args);
-
-    void erase(iterator iter);
-
-    iterator begin();
-    iterator end();
-    
-    const_iterator begin() const;
-    const_iterator end() const;
-
-    const_iterator cbegin() const;
-    const_iterator cend() const;
-
-    reverse_iterator rbegin();
-    reverse_iterator rend();
-
-    const_reverse_iterator rbegin() const;
-    const_reverse_iterator rend() const;
-
-    const_reverse_iterator crbegin() const;
-    const_reverse_iterator crend() const;
-
-    #ifdef _DEBUG
-    void print_arr() const;
-    void print_deque() const;
-    #endif /* _DEBUG */
-};
-
-// Private functions ---------------------------------------------------------------------------/
-template <typename T>
-std::pair<int, int> Deque<T>::pos_calc(const std::pair<int, int>& pos, size_t offset) const {
-    size_t begin = pos.first * bucket_size + pos.second;
-    size_t val = begin + offset;
-    return std::make_pair<int, int>(val / bucket_size, val % bucket_size);
-}
-
-template <typename T>
-void Deque<T>::pos_forward(std::pair<int, int>& pos) {
-    pos.second = pos.second + 1;
-    if (pos.second == bucket_size) {
-        ++pos.first;
-        pos.second = 0;
-    }
-}
-
-template <typename T>
-void Deque<T>::pos_back(std::pair<int, int>& pos) {
-    if (pos.second == 0) {
-        --pos.first;
-        pos.second = bucket_size - 1;
-    }
-    else pos.second = pos.second - 1;
-}
-
-template <typename T>
-bool Deque<T>::is_index_in_range(int i, int j) const {
-    return ((std::make_pair(i, j) >= begin_pos) && (std::make_pair(i, j) < end_pos));
-}
-
-template <typename T>
-bool Deque<T>::is_index_in_range(const std::pair<int, int>& val) const {
-    return ((val >= begin_pos) && (val < end_pos));
-}
-
-template <typename T>
-void Deque<T>::expand_back(size_t n) {
-    if (n < 2) return;
-    std::vector<T*> new_arr(bucket_count * n);
-    size_t new_bucket_count = bucket_count * n;
-    size_t new_cap = bucket_size * new_bucket_count;
-    for (size_t i = 0; i < new_bucket_count; ++i) {
-        new_arr[i] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]);
-        if (i < bucket_count) {
-            new_arr[i] = arr[i];
-        }
-    }
-    arr              = new_arr;
-    cap              = new_cap;
-    bucket_count     = new_bucket_count;
-}
-
-template <typename T>
-void Deque<T>::expand_front(size_t n) {
-    if (n < 2) return;
-    std::vector<T*> new_arr(bucket_count * n);
-    size_t new_bucket_count = bucket_count * n;
-    size_t new_cap = bucket_size * new_bucket_count;
-    for (size_t i = 0; i < new_bucket_count; ++i) {
-        new_arr[i] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]);
-        if (i >= bucket_count) {
-            new_arr[i] = arr[i - bucket_count];
-        }
-    }
-    arr              = new_arr;
-    cap              = new_cap;
-    begin_pos.first += bucket_count;
-    end_pos.first   += bucket_count;
-    bucket_count     = new_bucket_count;
-}
-
-// Public functions ----------------------------------------------------------------------------/
-template <typename T>
-Deque<T>::Deque() : arr(1), bucket_count(1), sz(0), cap(bucket_size), begin_pos{0, bucket_size / 2}, end_pos{0, bucket_size / 2} {
-    // arr[0] = new T[bucket_size]; // не подходит, т.к. вызовется конструктор по-умолчанию для T
-    arr[0] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]); // просто выделили память
-}
-
-template <typename T>
-Deque<T>::Deque(const Deque<T>& other) {
-    if (this == &other) {
-        return;
-    }
-
-    arr.resize(other.bucket_count);
-    
-    size_t i = 0;
-    size_t j;
-    try {
-        for ( ; i < other.bucket_count; ++i) {
-            arr[i] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]);
-            for (j = 0; j < bucket_size; ++j) {
-                if(other.is_index_in_range(i, j)) {
-                    new(arr[i] + j) T(*(other.arr[i] + j)); // placement new
-                }
-            }
-        }
-        bucket_count = other.bucket_count;
-        begin_pos    = other.begin_pos;
-        end_pos      = other.end_pos;
-        sz           = other.sz;
-        cap          = other.cap;
-    }
-    catch (...) {
-        for (size_t x = 0; x <= i; ++x) {
-            size_t y_end = (x == i) ? j : bucket_size;
-            for (size_t y = 0; y < y_end; ++y) {
-                (arr[x] + y)->~T(); // явный вызов деструктора по адресу
-            }
-            delete[] reinterpret_cast<int8_t*>(arr[x]); //освобождаем память 
-        }
-        throw;
-    }
-}
-
-template <typename T>
-Deque<T>::Deque(int n, const T& value) : sz(n), begin_pos{0, bucket_size / 2} {
-    if (n < 0) throw std::bad_alloc();
-
-    size_t first_indx = (bucket_size / 2);
-    size_t last_indx  = (n - 1 + first_indx) % bucket_size;
-    size_t buckets    = ((n + first_indx) / bucket_size) + (((n + first_indx) % bucket_size) == 0 ? 0 : 1);
-
-    size_t i = 0;
-    size_t j; 
-    try {
-        arr.resize(buckets);
-        cap          = buckets * bucket_size;
-        sz           = n; 
-        bucket_count = buckets;
-        end_pos      = pos_calc(begin_pos, sz);
-
-        for ( ; i < buckets; ++i) {
-            arr[i] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]);
-            for (j = 0; j < bucket_size; ++j) {
-                if(is_index_in_range(i, j)) {
-                    new(arr[i] + j) T(value);  // вызываем копирующий конструктор
-                }
-            }
-        }
-    }
-    catch(...) {
-        for (size_t x = 0; x <= i; ++x) {
-            size_t y_end = (x == i) ? j : bucket_size;
-            for (size_t y = 0; y < y_end; ++y) {
-                (arr[x] + y)->~T(); // явный вызов деструктора по адресу
-            }
-            delete[] reinterpret_cast<int8_t*>(arr[x]); // освобождаем память
-        }
-        throw;
-    }
-}
-
-template <typename T>
-Deque<T>::Deque(Deque<T>&& other) noexcept : arr(std::move(other.arr)), bucket_count(other.bucket_count), 
-                                             sz(other.sz), cap(other.cap), 
-                                             begin_pos(other.begin_pos), end_pos(other.end_pos) {
-    other.bucket_count = 0;
-    other.sz           = 0;
-    other.cap          = 0;
-}
-
-template <typename T>
-Deque<T>::~Deque() {
-    for (int i = 0; i < bucket_count; ++i) {
-        for (int j = 0; j < bucket_size; ++j) {
-            if (is_index_in_range(i, j)) {
-                (arr[i] + j)->~T(); // явный вызов деструктора по адресу
-            }
-        }
-
-        delete[] reinterpret_cast<int8_t*>(arr[i]); // освобождаем память
-    }
-}
-
-template <typename T>
-Deque<T>& Deque<T>::operator=(const Deque<T>& other) {
-    if (this == &other) {
-        return *this;
-    }
-
-    std::vector<T*> new_arr(other.bucket_count);
-
-    size_t i = 0;
-    size_t j;
-    try {
-        for ( ; i < other.bucket_count; ++i) {
-            new_arr[i] = reinterpret_cast<T*>(new int8_t[bucket_size * sizeof(T)]);
-            for (j = 0; j < bucket_size; ++j) {
-                if(other.is_index_in_range(i, j)) {
-                    new(new_arr[i] + j) T(*(other.arr[i] + j)); // placement new
-                }
-            }
-        }
-    }
-    catch (...) {
-        for (size_t x = 0; x <= i; ++x) {
-            size_t y_end = (x == i) ? j : bucket_size;
-            for (size_t y = 0; y < y_end; ++y) {
-                (new_arr[x] + y)->~T(); // явный вызов деструктора по адресу
-            }
-            delete[] reinterpret_cast<int8_t*>(new_arr[x]); //освобождаем память 
-        }
-        throw;
-    }    
-
-    // если все прошло без исключений, освобождаем старый вектор
-    for (size_t x = 0; x < bucket_count; ++x) {
-        for (size_t y = 0; y < bucket_size; ++y) {
-            if (is_index_in_range(x, y)) {
-                (arr[x] + y)->~T(); // явный вызов деструктора по адресу
-            }
-        }
-        delete[] reinterpret_cast<int8_t*>(arr[x]); //освобождаем память 
-    }
-
-    // копируем новый вектор
-    arr = new_arr;
-
-    // копируем состояние
-    bucket_count = other.bucket_count;
-    begin_pos    = other.begin_pos;
-    end_pos      = other.end_pos;
-    sz           = other.sz;
-    cap          = other.cap;
-
-    return *this;
-}
-
-template <typename T>
-Deque<T>& Deque<T>::operator=(Deque<T>&& other) noexcept {
-    arr          = std::move(other.arr);
-    bucket_count = other.bucket_count;
-    sz           = other.sz;
-    cap          = other.cap;
-    begin_pos    = other.begin_pos;
-    end_pos      = other.end_pos;
-
-    other.bucket_count = 0;
-    other.sz           = 0;
-    other.cap          = 0;
-}
-
-template <typename T>
-size_t Deque<T>::size() const {
-    return sz;
-}
-
-template <typename T>
-size_t Deque<T>::capacity() const {
-    return cap;
-}
-
-template <typename T>
-T& Deque<T>::operator[](size_t index) {
-    return const_cast<T&>(const_cast<const Deque<T>*>(this)->operator[](index));
-}
-
-template <typename T>
-const T& Deque<T>::operator[](size_t index) const {
-    std::pair<int, int> pos = pos_calc(begin_pos, index);
-    return arr[pos.first][pos.second];
-}
-
-template <typename T>
-T& Deque<T>::at(size_t index) {
-    return const_cast<T&>(const_cast<const Deque<T>*>(this)->at(index));
-}
-
-template <typename T>
-const T& Deque<T>::at(size_t index) const {
-    std::pair<int, int> pos = pos_calc(begin_pos, index);
-    if (is_index_in_range(pos)) return arr[pos.first][pos.second];
-    else throw std::out_of_range("at(): out of range");
-}
-
-template <typename T>
-void Deque<T>::push_back(const T& value){
-    emplace_back(value);
-}
-
-template <typename T>
-void Deque<T>::push_back(T&& value) {
-    emplace_back(std::move(value));
-}
-
-template <typename T>
-void Deque<T>::pop_back() {
-    if (sz == 0) {
-        return;
-    } 
-    --sz;
-    pos_back(end_pos);
-    (arr[end_pos.first] + end_pos.second)->~T();
-}
-
-template <typename T>
-void Deque<T>::push_front(const T& value) {
-    emplace_front(value);
-}
-
-template <typename T>
-void Deque<T>::push_front(T&& value) {
-    emplace_front(std::move(value));
-}
-
-template <typename T>
-void Deque<T>::pop_front() {
-    if (sz == 0) {
-        return;
-    } 
-    --sz;
-    (arr[begin_pos.first] + begin_pos.second)->~T();
-    pos_forward(begin_pos);
-}
-
-template <typename T>
-void Deque<T>::insert(iterator iter, const T& value) {
-    emplace(iter, value);
-}
-
-template <typename T>
-template <typename... Args>
-typename Deque<T>::iterator Deque<T>::emplace(iterator iter, Args&&... args) {
-    push_back(*(end() - 1));
-    for (iterator it = end() - 1; it != iter; --it) {
-        *it = std::move(*(it - 1));
-    }
-    new ( &(*iter) ) T(std::forward<Args>(args)...);
-    return iter;
-}
-
-template <typename T>
-template <typename... Args>
-void Deque<T>::emplace_back(Args&&... args) {
-    if ((end_pos.first * bucket_size + end_pos.second) == cap) {
-        expand_back();
-    }
-    ++sz;
-    new(arr[end_pos.first] + end_pos.second) T(std::forward<Args>(args)...);
-    pos_forward(end_pos);    
-}
-
-template <typename T>
-template <typename... Args>
-void Deque<T>::emplace_front(Args&&... args) {
-    if ((begin_pos.first == begin_pos.second) && (begin_pos.first == 0)) {
-        expand_front();
-    }
-    ++sz;
-    pos_back(begin_pos);
-    new(arr[begin_pos.first] + begin_pos.second) T(std::forward<Args>(args)...);    
-}
-
-template <typename T>
-void Deque<T>::erase(iterator iter) {
-    iterator it(iter);
-    for ( ; it != this->end(); ++it) {
-        *it = *(it + 1);
-    }
-    pop_back();
-}
-
-template <typename T>
-typename Deque<T>::iterator Deque<T>::begin() {
-    return iterator(arr, begin_pos);
-}
-
-template <typename T>
-typename Deque<T>::iterator Deque<T>::end() {
-    return iterator(arr, end_pos);
-}
-
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::begin() const {
-    return const_iterator(arr, begin_pos);
-}
-
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::end() const {
-    return const_iterator(arr, end_pos);
-}
-
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cbegin() const {
-    return const_iterator(arr, begin_pos);
-}
-
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cend() const {
-    return const_iterator(arr, end_pos);
-}
-
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rbegin() {
-    return reverse_iterator(iterator(arr, end_pos));
-}
-
-template <typename T>
-typename Deque<T>::reverse_iterator Deque<T>::rend() {
-    return reverse_iterator(iterator(arr, begin_pos));
-}
-
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rbegin() const {
-    return const_reverse_iterator(const_iterator(arr, end_pos));    
-}
-
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::rend() const {
-    return const_reverse_iterator(const_iterator(arr, begin_pos));
-}
-
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crbegin() const {
-    return const_reverse_iterator(const_iterator(arr, end_pos)); 
-}
-
-template <typename T>
-typename Deque<T>::const_reverse_iterator Deque<T>::crend() const {
-    return const_reverse_iterator(const_iterator(arr, begin_pos));
-}
-
-
-#ifdef _DEBUG
-template <typename T>
-void Deque<T>::print_arr() const {
-    for (int i = 0; i < bucket_count; ++i) {
-        for (int j = 0; j < bucket_size; ++j) {
-            std::cout << arr[i][j] << " ";
-        }
-        std::cout << std::endl;
-    }
-    std::cout << std::endl;
-}
-
-template <typename T>
-void Deque<T>::print_deque() const {
-    size_t count = 0;
-    for (int i = 0; i < bucket_count; ++i) {
-        for (int j = 0; j < bucket_size; ++j) {
-            if (is_index_in_range(i, j)) {
-                ++count;
-                std::cout << arr[i][j] << " ";
-            }
-        }
-    }
-    std::cout << "(" << count << " elements)" << std::endl << std::endl;
-}
-#endif /* _DEBUG */
-
-
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#ifdef _DEBUG
+#include <iostream>
+#endif /* _DEBUG */
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <stddef.h>
+#include <stdint.h>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+
+namespace deque_detail {
+
+constexpr size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+constexpr size_t log2_pow2(size_t n) {
+    size_t shift = 0;
+    while ((size_t(1) << shift) < n) ++shift;
+    return shift;
+}
+
+// бакет по умолчанию занимает ~4 KiB (степень двойки), но не меньше 16 элементов
+template <typename T>
+constexpr size_t default_bucket_size() {
+    constexpr size_t block_bytes = 4096;
+    size_t n = 16;
+    while (n * 2 * sizeof(T) <= block_bytes) n *= 2;
+    return n;
+}
+
+// аллокаторы, у которых destroy() - это просто ~T()
+template <typename Allocator>
+struct has_plain_destroy : std::false_type {};
+
+template <typename U>
+struct has_plain_destroy<std::allocator<U>> : std::true_type {};
+
+#if __has_include(<memory_resource>)
+template <typename U>
+struct has_plain_destroy<std::pmr::polymorphic_allocator<U>> : std::true_type {};
+#endif
+
+// аллокаторы, у которых construct() - это просто placement new,
+// т.е. можно заполнять бакеты через std::uninitialized_copy (memmove для тривиальных T)
+template <typename Allocator>
+struct has_plain_construct : std::false_type {};
+
+template <typename U>
+struct has_plain_construct<std::allocator<U>> : std::true_type {};
+
+#if __has_include(<memory_resource>)
+template <typename U>
+struct has_plain_construct<std::pmr::polymorphic_allocator<U>> 
+    : std::integral_constant<bool, !std::uses_allocator<U, std::pmr::polymorphic_allocator<U>>::value> {};
+#endif
+
+template <typename It>
+using iterator_category_t = typename std::iterator_traits<It>::iterator_category;
+
+template <typename It, typename = void>
+struct is_input_iterator : std::false_type {};
+
+template <typename It>
+struct is_input_iterator<It, std::enable_if_t<std::is_convertible<iterator_category_t<It>, std::input_iterator_tag>::value>> 
+    : std::true_type {};
+
+template <typename It, typename = void>
+struct is_forward_iterator : std::false_type {};
+
+template <typename It>
+struct is_forward_iterator<It, std::enable_if_t<std::is_convertible<iterator_category_t<It>, std::forward_iterator_tag>::value>> 
+    : std::true_type {};
+
+template <typename Allocator>
+void propagate_allocator(Allocator& dst, const Allocator& src, std::true_type) {
+    dst = src;
+}
+
+template <typename Allocator>
+void propagate_allocator(Allocator&, const Allocator&, std::false_type) {}
+
+template <typename Allocator>
+void propagate_allocator_swap(Allocator& lhs, Allocator& rhs, std::true_type) {
+    using std::swap;
+    swap(lhs, rhs);
+}
+
+template <typename Allocator>
+void propagate_allocator_swap(Allocator&, Allocator&, std::false_type) {}
+
+// Заголовок файла Deque::save(). Поля пишутся в порядке байтов машины, которая сохраняла,
+// за заголовком с file_data_offset лежат бакеты целиком, по bucket_size элементов.
+struct file_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t element_size;
+    uint64_t bucket_size;
+    uint64_t size;          // число элементов
+    uint64_t first_offset;  // слот первого элемента в первом бакете
+    uint64_t buckets;       // число бакетов в файле
+};
+
+constexpr char     file_magic[8]   = {'D', 'E', 'Q', 'U', 'E', 'B', 'I', 'N'};
+constexpr uint32_t file_version    = 1;
+constexpr uint32_t file_byte_order = 0x01020304;
+// бакеты начинаются с границы страницы, чтобы в отображенном файле они были выровнены под любой T
+constexpr size_t   file_data_offset = 4096;
+
+inline file_header make_file_header(size_t element_size, size_t bucket_size, size_t size, size_t first_offset) {
+    file_header header;
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version      = file_version;
+    header.byte_order   = file_byte_order;
+    header.element_size = element_size;
+    header.bucket_size  = bucket_size;
+    header.size         = size;
+    header.first_offset = first_offset;
+    header.buckets      = size == 0 ? 0 : (first_offset + size + bucket_size - 1) / bucket_size;
+    return header;
+}
+
+// бросает std::runtime_error, если файл записан не для этого Deque<T, BucketSize> или обрезан
+inline void check_file_header(const file_header& header, size_t element_size, size_t bucket_size, uint64_t file_size,
+                              const std::string& path) {
+    if (file_size < file_data_offset || std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+        header.version != file_version || header.byte_order != file_byte_order) {
+        throw std::runtime_error("Deque: " + path + " is not a Deque file of this version and byte order");
+    }
+    if (header.element_size != element_size || header.bucket_size != bucket_size) {
+        throw std::runtime_error("Deque: " + path + " was saved with a different element type or bucket size");
+    }
+    // размер проверяется до подсчета бакетов: иначе first_offset + size + bucket_size - 1 переполняется
+    // (size = UINT64_MAX дает 0 бакетов) и дек без бакетов получает огромный размер
+    uint64_t max_size = uint64_t(PTRDIFF_MAX) / element_size;
+    if (header.first_offset >= bucket_size || header.size > max_size || header.size > UINT64_MAX - header.first_offset - bucket_size) {
+        throw std::runtime_error("Deque: " + path + " is corrupted or truncated");
+    }
+    uint64_t buckets = header.size == 0 ? 0 : (header.first_offset + header.size + bucket_size - 1) / bucket_size;
+    if (header.buckets != buckets ||
+        (file_size - file_data_offset) / (bucket_size * element_size) < buckets) {
+        throw std::runtime_error("Deque: " + path + " is corrupted or truncated");
+    }
+}
+
+} // namespace deque_detail
+
+
+// Тип можно переносить побайтно: memmove в новое место вместо move-конструктора и
+// деструктора старого объекта. По умолчанию это тривиально копируемые типы; для своих
+// типов (например, структур с std::unique_ptr) можно включить специализацией:
+//   template <> struct deque_relocatable<MyType> : std::true_type {};
+template <typename T>
+struct deque_relocatable : std::is_trivially_copyable<T> {};
+
+
+// Политики статистики для четвертого параметра Deque. Deque наследуется от политики закрыто,
+// так что пустая deque_no_stats не занимает места, а ее пустые on_*() исчезают после инлайна.
+struct deque_no_stats {
+    void on_bucket_allocate() {}
+    void on_bucket_deallocate() {}
+    void on_expand_back(size_t /*bytes_copied*/) {}
+    void on_expand_front(size_t /*bytes_copied*/) {}
+    void on_shift(size_t /*elements*/) {}
+    void on_size(size_t /*size*/, size_t /*capacity*/) {}
+};
+
+struct deque_stats {
+    size_t buckets_allocated  = 0;
+    size_t buckets_freed      = 0;
+    size_t expand_back_calls  = 0;
+    size_t expand_front_calls = 0;
+    size_t map_bytes_copied   = 0;  // указатели на бакеты, перенесенные при росте/сдвиге карты
+    size_t elements_shifted   = 0;  // элементы, сдвинутые insert/emplace/erase
+    size_t peak_size          = 0;
+    size_t peak_capacity      = 0;
+
+    void on_bucket_allocate() {
+        ++buckets_allocated;
+    }
+
+    void on_bucket_deallocate() {
+        ++buckets_freed;
+    }
+
+    void on_expand_back(size_t bytes_copied) {
+        ++expand_back_calls;
+        map_bytes_copied += bytes_copied;
+    }
+
+    void on_expand_front(size_t bytes_copied) {
+        ++expand_front_calls;
+        map_bytes_copied += bytes_copied;
+    }
+
+    void on_shift(size_t elements) {
+        elements_shifted += elements;
+    }
+
+    void on_size(size_t size, size_t capacity) {
+        peak_size     = std::max(peak_size, size);
+        peak_capacity = std::max(peak_capacity, capacity);
+    }
+
+    void reset() {
+        *this = deque_stats();
+    }
+};
+
+// Результат Deque::memory_usage(), в байтах
+struct deque_memory_usage {
+    size_t live_bytes;    // size() * sizeof(T)
+    size_t bucket_bytes;  // бакеты, висящие в карте
+    size_t spare_bytes;   // бакеты в пуле
+    size_t map_bytes;     // сама карта и пул указателей
+
+    size_t total_bytes() const {
+        return bucket_bytes + spare_bytes + map_bytes;
+    }
+
+    size_t slack_bytes() const {
+        return total_bytes() - live_bytes;
+    }
+};
+
+// Результат Deque::bucket_occupancy()
+struct deque_bucket_occupancy {
+    size_t map_slots;      // слотов в карте
+    size_t buckets;        // из них с выделенным бакетом
+    size_t spare_buckets;  // бакетов в пуле
+    size_t bucket_size;    // элементов в бакете
+    size_t elements;
+
+    // доля занятых слотов в выделенных бакетах
+    double fill_ratio() const {
+        return buckets == 0 ? 0.0 : double(elements) / double(buckets * bucket_size);
+    }
+};
+
+
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Allocator = std::allocator<T>,
+          typename Stats = deque_no_stats>
+class Deque : private Stats {
+private:
+    static_assert(BucketSize > 0, "Deque: bucket size must be positive");
+
+    // размер бакета округляется до степени двойки, чтобы индекс -> (бакет, слот) считался сдвигом и маской
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    // сколько освободившихся крайних бакетов держать про запас по умолчанию
+    static constexpr size_t default_spare_limit = 4;
+
+    // сдвиги внутри дека делаются memmove-ом по кускам бакетов
+    static constexpr bool relocate_by_memmove = deque_relocatable<T>::value &&
+                                                deque_detail::has_plain_construct<Allocator>::value &&
+                                                deque_detail::has_plain_destroy<Allocator>::value;
+
+    using alloc_traits  = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<T*>;
+    using map_type      = std::vector<T*, map_allocator>;
+
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value, "Deque: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value, "Deque: fancy pointers are not supported");
+
+    Allocator alloc;
+    map_type arr;
+    size_t bucket_count;
+    size_t sz;
+    size_t cap;
+    std::pair<size_t, size_t> begin_pos;
+    std::pair<size_t, size_t> end_pos;
+
+    map_type spare;  // пул пустых бакетов для повторного использования
+    size_t spare_max;
+
+    std::pair<size_t, size_t> pos_calc(const std::pair<size_t, size_t>& pos, size_t offset) const;
+    void pos_forward(std::pair<size_t, size_t>& pos);
+    void pos_back(std::pair<size_t, size_t>& pos);
+
+    T* allocate_bucket();
+    void deallocate_bucket(T* bucket);
+    T* acquire_bucket();
+    void release_bucket(T*& bucket);
+
+    void copy_buckets(const Deque& other, map_type& dst);
+    void destroy_elements();
+    void destroy_all();
+    void reset_empty();
+    void init_map();
+    void free_spare();
+
+    template <typename ForwardIt>
+    ForwardIt uninitialized_copy_a(ForwardIt first, size_t count, T* dst);
+    void uninitialized_fill_a(T* dst, size_t count, const T& value);
+    template <typename Fill>
+    void construct_at(std::pair<size_t, size_t> pos, size_t n, Fill fill);
+    template <typename ForwardIt>
+    void append_forward(ForwardIt first, size_t n);
+    template <typename ForwardIt>
+    void prepend_forward(ForwardIt first, size_t n);
+    template <typename InputIt>
+    void append_iter(InputIt first, InputIt last);
+    template <typename InputIt>
+    void prepend_iter(InputIt first, InputIt last);
+    template <typename ForwardIt>
+    void insert_forward(size_t index, ForwardIt first, size_t n);
+    template <typename F>
+    void for_each_chunk(std::pair<size_t, size_t> pos, size_t n, F f);
+    void destroy_chunk(T* first, T* last);
+    void destroy_range(std::pair<size_t, size_t> pos, size_t n);
+    template <typename OutputIt>
+    OutputIt move_out(std::pair<size_t, size_t> pos, size_t n, OutputIt out);
+    void ensure_buckets(std::pair<size_t, size_t> pos, size_t n);
+    void relocate_range(std::pair<size_t, size_t> src, std::pair<size_t, size_t> dst, size_t n);
+    void drop_front_raw(size_t n);
+    void drop_back_raw(size_t n);
+    void clear_raw();
+    void relocate_n(T* src, size_t n, T* dst);
+    void take_layout(Deque& other);
+
+    void reserve_map(size_t front_elems, size_t back_elems);
+    void adopt_layout(size_t buckets, size_t first_offset, size_t n);
+    bool recenter();
+    void expand_back(size_t n = 2);
+    void expand_front(size_t n = 2);
+
+    bool is_index_in_range(size_t i, size_t j) const;
+    bool is_index_in_range(const std::pair<size_t, size_t>& val) const;
+
+    // Сегментный итератор: текущий элемент, границы его бакета и слот карты.
+    // ++/--/сравнения работают только с указателями, в карту он заходит лишь при переходе
+    // в соседний бакет. Слот карты под end() есть всегда (см. emplace_back), но бакета
+    // в нем может не быть - тогда first/cur/last равны nullptr.
+    template <bool IsConst>
+    class common_iterator {
+    private:
+        template <bool> friend class common_iterator;
+
+        using ConditionalPtr  = std::conditional_t<IsConst, const T*, T*>;
+        using ConditionalRef  = std::conditional_t<IsConst, const T&, T&>;
+        using ConditionalType = std::conditional_t<IsConst, const T, T>;
+
+        ConditionalPtr cur;
+        ConditionalPtr first;
+        ConditionalPtr last;
+        T* const*      node;
+
+        void set_node(T* const* new_node) {
+            node  = new_node;
+            first = *node;
+            last  = first != nullptr ? first + bucket_size : nullptr;
+        }
+
+    public:
+        using iterator_category      = std::random_access_iterator_tag;
+        using difference_type        = std::ptrdiff_t;
+        using value_type             = ConditionalType;
+        using pointer                = ConditionalPtr;
+        using reference              = ConditionalRef;    
+
+        common_iterator() : cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
+
+        common_iterator(T* const* node, size_t offset) {
+            set_node(node);
+            cur = first != nullptr ? first + offset : nullptr;
+        }
+
+        // iterator -> const_iterator
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        common_iterator(const common_iterator<OtherConst>& other) 
+        : cur(other.cur), first(other.first), last(other.last), node(other.node) {}
+
+        common_iterator& operator++() {
+            if (++cur == last) {
+                set_node(node + 1);
+                cur = first;
+            }
+            return *this;
+        }
+        
+        common_iterator& operator--() {
+            if (cur == first) {
+                set_node(node - 1);
+                cur = last;
+            }
+            --cur;
+            return *this;
+        }
+
+        common_iterator operator++(int) {
+            common_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+        
+        common_iterator operator--(int) {
+            common_iterator old = *this;
+            --(*this);
+            return old;
+        }
+
+        common_iterator& operator+=(difference_type n) {
+            difference_type offset = n + (cur - first);
+            if (offset >= 0 && offset < static_cast<difference_type>(bucket_size)) {
+                cur += n;
+            } else {
+                // деление с округлением вниз и для отрицательных смещений
+                difference_type node_offset = offset > 0 ? offset / static_cast<difference_type>(bucket_size)
+                                                         : -((-offset - 1) / static_cast<difference_type>(bucket_size)) - 1;
+                set_node(node + node_offset);
+                cur = first + (offset - node_offset * static_cast<difference_type>(bucket_size));
+            }
+            return *this;
+        }
+
+        common_iterator& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        common_iterator operator+(difference_type n) const {
+            common_iterator tmp = *this;
+            return tmp += n;
+        }
+
+        common_iterator operator-(difference_type n) const {
+            common_iterator tmp = *this;
+            return tmp += -n;
+        }
+
+        bool operator<(const common_iterator<IsConst>& other) const {
+            return node == other.node ? cur < other.cur : node < other.node;
+        }
+
+        bool operator<=(const common_iterator<IsConst>& other) const {
+            return !(other < *this);
+        }
+
+        bool operator>=(const common_iterator<IsConst>& other) const {
+            return !(*this < other);
+        }
+
+        bool operator>(const common_iterator<IsConst>& other) const {
+            return other < *this;
+        }
+
+        bool operator==(const common_iterator<IsConst>& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const common_iterator<IsConst>& other) const {
+            return cur != other.cur;
+        }
+
+        difference_type operator-(const common_iterator<IsConst>& other) const {
+            return (node - other.node) * static_cast<difference_type>(bucket_size) + (cur - first) - (other.cur - other.first);
+        }
+
+        ConditionalRef operator*() const {
+            return *cur;
+        }
+
+        ConditionalPtr operator->() const {
+            return cur;
+        }
+
+        ConditionalRef operator[](difference_type n) const {
+            return *(*this + n);
+        }
+    };
+
+    template <typename Iter>
+    Iter make_iterator(const std::pair<size_t, size_t>& pos) const;
+
+public:
+    using value_type             = T;
+    using allocator_type         = Allocator;
+    using size_type              = size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using iterator               = common_iterator<false>;
+    using const_iterator         = common_iterator<true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    Deque();
+    explicit Deque(const Allocator& allocator);
+    explicit Deque(const Deque& other);
+    Deque(const Deque& other, const Allocator& allocator);
+    Deque(int n, const T& value = T(), const Allocator& allocator = Allocator());
+    Deque(Deque&& other) noexcept;
+    Deque(Deque&& other, const Allocator& allocator);
+    template <typename InputIt, typename = std::enable_if_t<deque_detail::is_input_iterator<InputIt>::value>>
+    Deque(InputIt first, InputIt last, const Allocator& allocator = Allocator());
+    Deque(std::initializer_list<T> init, const Allocator& allocator = Allocator());
+    ~Deque();
+
+    Deque& operator=(const Deque& other);
+    Deque& operator=(Deque&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                             alloc_traits::is_always_equal::value);
+
+    void swap(Deque& other) noexcept;
+    allocator_type get_allocator() const;
+
+    void assign(size_t n, const T& value);
+    template <typename InputIt, typename = std::enable_if_t<deque_detail::is_input_iterator<InputIt>::value>>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> init);
+    template <typename Range>
+    void assign_range(Range&& range);
+
+    template <typename Range>
+    void append_range(Range&& range);
+    template <typename Range>
+    void prepend_range(Range&& range);
+
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+
+    T& at(size_t index);
+    const T& at(size_t index) const;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    void clear();
+
+    size_t spare_limit() const;
+    void set_spare_limit(size_t n);
+
+    // reserve(n): push_back не выделяет память, пока size() <= n; reserve_front(n) - то же для push_front
+    void reserve(size_t n);
+    void reserve_front(size_t n);
+    void shrink_to_fit();
+
+    const Stats& stats() const;
+    Stats& stats();
+    deque_memory_usage memory_usage() const;
+    deque_bucket_occupancy bucket_occupancy() const;
+
+    // Сохранение для тривиально копируемых T: заголовок и занятые бакеты как есть, без обхода элементов.
+    // Файл читается тем же Deque<T, BucketSize> на машине с тем же порядком байтов.
+    void save(const std::string& path) const;
+    // бакеты читаются из файла одним fread каждый
+    static Deque load(const std::string& path, const Allocator& allocator = Allocator());
+    // бакеты указывают прямо в отображение файла (MAP_PRIVATE: измененные страницы копируются,
+    // файл не меняется); Allocator должен уметь map_file(), например deque_mapped_allocator из deque_mmap.h
+    static Deque load_mapped(const std::string& path);
+
+    void push_back(const T& value = T());
+    void push_back(T&& value);
+
+    void push_front(const T& value = T());
+    void push_front(T&& value);
+
+    void pop_back();
+    void pop_front();
+
+    // Пакетное удаление: до n элементов (не больше size()) разрушаются кусками бакетов, опустевшие
+    // бакеты освобождаются или уходят в пул один раз за вызов. Возвращают число удаленных элементов.
+    size_t pop_front_n(size_t n);
+    size_t pop_back_n(size_t n);
+    // первые/последние до n элементов перемещаются в out в порядке дека и удаляются, как pop_*_n
+    template <typename OutputIt>
+    OutputIt drain_front(OutputIt out, size_t n);
+    template <typename OutputIt>
+    OutputIt drain_back(OutputIt out, size_t n);
+
+    iterator insert(iterator iter, const T& value);
+    iterator insert(iterator iter, T&& value);
+    template <typename InputIt, typename = std::enable_if_t<deque_detail::is_input_iterator<InputIt>::value>>
+    iterator insert(iterator iter, InputIt first, InputIt last);
+    iterator insert(iterator iter, std::initializer_list<T> init);
+
+    template <typename... Args>
+    iterator emplace(iterator iter, Args&&... args);
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    template <typename... Args>
+    void emplace_front(Args&&... args);
+
+    iterator erase(iterator iter);
+    iterator erase(iterator first, iterator last);
+
+    // Перенос всех элементов other в конец/начало дека, other становится пустым. Бакеты other
+    // переходят по указателям, копируется не больше одного бакета на стыке - если позиция стыка
+    // в бакете у обоих деков совпадает (например, оба заполнялись с начала бакета) и аллокаторы
+    // равны. Иначе элементы меньшего из двух деков переносятся поэлементно.
+    void splice_back(Deque&& other);
+    void splice_front(Deque&& other);
+    // элементы [index, size()) уходят в возвращаемый дек: бакеты целиком, копируется только
+    // часть бакета, в котором лежит index
+    Deque split_at(size_t index);
+
+    iterator begin();
+    iterator end();
+    
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+    // обход по непрерывным кускам бакетов: f(first, last) для каждого занятого бакета по порядку;
+    // если f возвращает bool, то false прекращает обход
+    template <typename F>
+    void for_each_segment(F&& f);
+    template <typename F>
+    void for_each_segment(F&& f) const;
+
+    #ifdef _DEBUG
+    void print_arr() const;
+    void print_deque() const;
+    #endif /* _DEBUG */
+};
+
+// Private functions ---------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+std::pair<size_t, size_t> Deque<T, BucketSize, Allocator, Stats>::pos_calc(const std::pair<size_t, size_t>& pos, size_t offset) const {
+    size_t begin = (pos.first << bucket_shift) + pos.second;
+    size_t val = begin + offset;
+    return std::make_pair<size_t, size_t>(val >> bucket_shift, val & bucket_mask);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::pos_forward(std::pair<size_t, size_t>& pos) {
+    pos.second = pos.second + 1;
+    if (pos.second == bucket_size) {
+        ++pos.first;
+        pos.second = 0;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::pos_back(std::pair<size_t, size_t>& pos) {
+    if (pos.second == 0) {
+        --pos.first;
+        pos.second = bucket_size - 1;
+    }
+    else pos.second = pos.second - 1;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+bool Deque<T, BucketSize, Allocator, Stats>::is_index_in_range(size_t i, size_t j) const {
+    return ((std::make_pair(i, j) >= begin_pos) && (std::make_pair(i, j) < end_pos));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+bool Deque<T, BucketSize, Allocator, Stats>::is_index_in_range(const std::pair<size_t, size_t>& val) const {
+    return ((val >= begin_pos) && (val < end_pos));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename Iter>
+Iter Deque<T, BucketSize, Allocator, Stats>::make_iterator(const std::pair<size_t, size_t>& pos) const {
+    // у пустой карты нет слотов: begin() == end() - итераторы по умолчанию
+    return bucket_count == 0 ? Iter() : Iter(arr.data() + pos.first, pos.second);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T* Deque<T, BucketSize, Allocator, Stats>::allocate_bucket() {
+    // только память под bucket_size элементов, конструкторы T не вызываются
+    T* bucket = alloc_traits::allocate(alloc, bucket_size);
+    Stats::on_bucket_allocate();
+    return bucket;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::deallocate_bucket(T* bucket) {
+    if (bucket != nullptr) {
+        alloc_traits::deallocate(alloc, bucket, bucket_size); // освобождаем память
+        Stats::on_bucket_deallocate();
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T* Deque<T, BucketSize, Allocator, Stats>::acquire_bucket() {
+    if (spare.empty()) {
+        return allocate_bucket();
+    }
+    T* bucket = spare.back();
+    spare.pop_back();
+    return bucket;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::release_bucket(T*& bucket) {
+    if (spare.size() < spare_max) {
+        spare.push_back(bucket);
+    } else {
+        deallocate_bucket(bucket);
+    }
+    bucket = nullptr;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::copy_buckets(const Deque& other, map_type& dst) {
+    size_t done = 0;
+    try {
+        // бакеты выделяются только под занятую часть карты, остальные слоты остаются nullptr
+        for (size_t i = other.begin_pos.first; i <= other.end_pos.first && i < other.bucket_count; ++i) {
+            dst[i] = allocate_bucket();
+        }
+        // раскладка та же, что у other: копируем кусками бакетов (memmove для тривиально копируемых T)
+        size_t b = other.begin_pos.first;
+        other.for_each_segment([&](const T* first, const T* last) {
+            T* out = dst[b] + (first - other.arr[b]);
+            uninitialized_copy_a(first, last - first, out);
+            done += last - first;
+            ++b;
+        });
+    }
+    catch (...) {
+        std::pair<size_t, size_t> x = other.begin_pos;
+        for (size_t i = 0; i < done; ++i, pos_forward(x)) {
+            alloc_traits::destroy(alloc, dst[x.first] + x.second);
+        }
+        for (T*& bucket : dst) {
+            deallocate_bucket(bucket);
+            bucket = nullptr;
+        }
+        throw;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::destroy_elements() {
+    // для тривиально разрушаемых T обход элементов не нужен
+    if (!std::is_trivially_destructible<T>::value || !deque_detail::has_plain_destroy<Allocator>::value) {
+        for (std::pair<size_t, size_t> pos = begin_pos; pos != end_pos; pos_forward(pos)) {
+            alloc_traits::destroy(alloc, arr[pos.first] + pos.second);
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::destroy_all() {
+    destroy_elements();
+    for (T* bucket : arr) {
+        deallocate_bucket(bucket);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::reset_empty() {
+    // пустая карта без бакетов: первая же вставка создаст её через expand_back()/expand_front()
+    arr.clear();
+    bucket_count = 0;
+    sz           = 0;
+    cap          = 0;
+    begin_pos    = {0, 0};
+    end_pos      = {0, 0};
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::init_map() {
+    arr.assign(1, nullptr);
+    bucket_count = 1;
+    cap          = bucket_size;
+    begin_pos    = {0, bucket_size / 2};
+    end_pos      = begin_pos;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::free_spare() {
+    for (T* bucket : spare) {
+        deallocate_bucket(bucket);
+    }
+    spare.clear();
+    spare.shrink_to_fit();
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename ForwardIt>
+ForwardIt Deque<T, BucketSize, Allocator, Stats>::uninitialized_copy_a(ForwardIt first, size_t count, T* dst) {
+    if constexpr (deque_detail::has_plain_construct<Allocator>::value) {
+        ForwardIt last = std::next(first, count);
+        std::uninitialized_copy(first, last, dst); // для тривиально копируемых T это memmove
+        return last;
+    } else {
+        size_t i = 0;
+        try {
+            for ( ; i < count; ++i, ++first) {
+                alloc_traits::construct(alloc, dst + i, *first);
+            }
+        }
+        catch (...) {
+            for (size_t j = 0; j < i; ++j) {
+                alloc_traits::destroy(alloc, dst + j);
+            }
+            throw;
+        }
+        return first;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::uninitialized_fill_a(T* dst, size_t count, const T& value) {
+    if constexpr (deque_detail::has_plain_construct<Allocator>::value) {
+        std::uninitialized_fill_n(dst, count, value);
+    } else {
+        size_t i = 0;
+        try {
+            for ( ; i < count; ++i) {
+                alloc_traits::construct(alloc, dst + i, value);
+            }
+        }
+        catch (...) {
+            for (size_t j = 0; j < i; ++j) {
+                alloc_traits::destroy(alloc, dst + j);
+            }
+            throw;
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename Fill>
+void Deque<T, BucketSize, Allocator, Stats>::construct_at(std::pair<size_t, size_t> pos, size_t n, Fill fill) {
+    // заполняет n сырых слотов начиная с pos целыми кусками бакетов: fill(dst, count);
+    // при исключении уже созданные элементы уничтожаются, begin_pos/end_pos не трогаются
+    std::pair<size_t, size_t> start = pos;
+    size_t done = 0;
+    try {
+        while (done < n) {
+            if (arr[pos.first] == nullptr) {
+                arr[pos.first] = acquire_bucket();
+            }
+            size_t chunk = std::min(n - done, bucket_size - pos.second);
+            fill(arr[pos.first] + pos.second, chunk);
+            done += chunk;
+            pos   = pos_calc(pos, chunk);
+        }
+    }
+    catch (...) {
+        for ( ; start != pos; pos_forward(start)) {
+            alloc_traits::destroy(alloc, arr[start.first] + start.second);
+        }
+        throw;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename ForwardIt>
+void Deque<T, BucketSize, Allocator, Stats>::append_forward(ForwardIt first, size_t n) {
+    reserve_map(0, n);
+    construct_at(end_pos, n, [&](T* dst, size_t count) { first = uninitialized_copy_a(first, count, dst); });
+    end_pos = pos_calc(end_pos, n);
+    sz += n;
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename ForwardIt>
+void Deque<T, BucketSize, Allocator, Stats>::prepend_forward(ForwardIt first, size_t n) {
+    reserve_map(n, 0);
+    std::pair<size_t, size_t> pos = pos_calc(begin_pos, size_t(0) - n);
+    construct_at(pos, n, [&](T* dst, size_t count) { first = uninitialized_copy_a(first, count, dst); });
+    begin_pos = pos;
+    sz += n;
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename InputIt>
+void Deque<T, BucketSize, Allocator, Stats>::append_iter(InputIt first, InputIt last) {
+    if constexpr (deque_detail::is_forward_iterator<InputIt>::value) {
+        append_forward(first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        for ( ; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename InputIt>
+void Deque<T, BucketSize, Allocator, Stats>::prepend_iter(InputIt first, InputIt last) {
+    if constexpr (deque_detail::is_forward_iterator<InputIt>::value) {
+        prepend_forward(first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        // однопроходный диапазон: сначала собираем его, чтобы узнать длину
+        Deque tmp(first, last, alloc);
+        prepend_forward(std::make_move_iterator(tmp.begin()), tmp.size());
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename ForwardIt>
+void Deque<T, BucketSize, Allocator, Stats>::insert_forward(size_t index, ForwardIt first, size_t n) {
+    // вставка n элементов перед index: раздвигается та сторона, где элементов меньше,
+    // каждый сдвигаемый элемент перемещается ровно один раз
+    if (n == 0) {
+        return;
+    }
+    auto copy_from = [this](auto& src) {
+        return [this, &src](T* dst, size_t count) { src = uninitialized_copy_a(src, count, dst); };
+    };
+    Stats::on_shift(std::min(index, sz - index));
+
+    if constexpr (relocate_by_memmove) {
+        // раздвигаем сырую щель memmove-ом и строим в ней диапазон; при исключении сдвигаем обратно
+        std::pair<size_t, size_t> gap;
+        bool front = index < sz - index;
+        if (front) {
+            reserve_map(n, 0);
+            std::pair<size_t, size_t> new_begin = pos_calc(begin_pos, size_t(0) - n);
+            ensure_buckets(new_begin, n);
+            relocate_range(begin_pos, new_begin, index);
+            begin_pos = new_begin;
+            gap       = pos_calc(begin_pos, index);
+        } else {
+            reserve_map(0, n);
+            ensure_buckets(end_pos, n);
+            gap = pos_calc(begin_pos, index);
+            relocate_range(gap, pos_calc(gap, n), sz - index);
+            end_pos = pos_calc(end_pos, n);
+        }
+        try {
+            construct_at(gap, n, copy_from(first));
+        }
+        catch (...) {
+            if (front) {
+                relocate_range(begin_pos, pos_calc(begin_pos, n), index);
+                begin_pos = pos_calc(begin_pos, n);
+            } else {
+                relocate_range(pos_calc(gap, n), gap, sz - index);
+                end_pos = pos_calc(end_pos, size_t(0) - n);
+            }
+            throw;
+        }
+        sz += n;
+    } else if (index < sz - index) {
+        reserve_map(n, 0);
+        std::pair<size_t, size_t> new_begin = pos_calc(begin_pos, size_t(0) - n);
+        size_t moved = std::min(index, n);
+
+        // первые moved элементов переезжают в сырые слоты перед begin_pos
+        auto old_front = std::make_move_iterator(begin());
+        construct_at(new_begin, moved, copy_from(old_front));
+        if (index < n) {
+            // начало диапазона ложится в оставшиеся сырые слоты
+            ForwardIt head = first;
+            try {
+                construct_at(pos_calc(new_begin, index), n - index, copy_from(head));
+            }
+            catch (...) {
+                destroy_range(new_begin, moved);
+                throw;
+            }
+        }
+        begin_pos = new_begin;
+        sz       += n;
+
+        if (index >= n) {
+            std::move(begin() + 2 * n, begin() + index + n, begin() + n);
+            std::copy_n(first, n, begin() + index);
+        } else {
+            std::copy_n(std::next(first, n - index), index, begin() + n);
+        }
+    } else {
+        reserve_map(0, n);
+        size_t after = sz - index;
+
+        if (after > n) {
+            // последние n элементов переезжают в сырые слоты после end_pos
+            auto old_back = std::make_move_iterator(begin() + (sz - n));
+            construct_at(end_pos, n, copy_from(old_back));
+            end_pos = pos_calc(end_pos, n);
+            sz     += n;
+            std::move_backward(begin() + index, begin() + (sz - 2 * n), begin() + (sz - n));
+            std::copy_n(first, n, begin() + index);
+        } else {
+            // хвост диапазона, затем сдвигаемые элементы ложатся в сырые слоты после end_pos
+            ForwardIt tail = std::next(first, after);
+            construct_at(end_pos, n - after, copy_from(tail));
+            try {
+                auto old_back = std::make_move_iterator(begin() + index);
+                construct_at(pos_calc(end_pos, n - after), after, copy_from(old_back));
+            }
+            catch (...) {
+                destroy_range(end_pos, n - after);
+                throw;
+            }
+            end_pos = pos_calc(end_pos, n);
+            sz     += n;
+            std::copy_n(first, after, begin() + index);
+        }
+    }
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename F>
+void Deque<T, BucketSize, Allocator, Stats>::for_each_chunk(std::pair<size_t, size_t> pos, size_t n, F f) {
+    // f(first, last) для n занятых слотов начиная с pos, кусками в пределах бакета
+    while (n > 0) {
+        size_t chunk = std::min(n, bucket_size - pos.second);
+        T* first     = arr[pos.first] + pos.second;
+        f(first, first + chunk);
+        n -= chunk;
+        pos = pos_calc(pos, chunk);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::destroy_chunk(T* first, T* last) {
+    // для тривиально разрушаемых T обход не нужен
+    if (std::is_trivially_destructible<T>::value && deque_detail::has_plain_destroy<Allocator>::value) return;
+    for ( ; first != last; ++first) {
+        alloc_traits::destroy(alloc, first);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::destroy_range(std::pair<size_t, size_t> pos, size_t n) {
+    if (std::is_trivially_destructible<T>::value && deque_detail::has_plain_destroy<Allocator>::value) return;
+    for_each_chunk(pos, n, [this](T* first, T* last) { destroy_chunk(first, last); });
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename OutputIt>
+OutputIt Deque<T, BucketSize, Allocator, Stats>::move_out(std::pair<size_t, size_t> pos, size_t n, OutputIt out) {
+    // перемещает n элементов с pos в out и разрушает их; слоты остаются сырыми, позиции не меняются
+    if constexpr (std::is_trivially_destructible<T>::value && deque_detail::has_plain_destroy<Allocator>::value) {
+        // разрушать нечего, std::move по указателям для тривиальных T - memmove
+        for_each_chunk(pos, n, [&out](T* first, T* last) { out = std::move(first, last, out); });
+    } else if constexpr (noexcept(*out = std::move(*arr[0])) && noexcept(++out)) {
+        // каждый элемент разрушается сразу после перемещения: память, которую он держал
+        // (например, старый буфер строки из out), освобождается, пока она еще в кэше
+        for_each_chunk(pos, n, [&](T* first, T* last) {
+            for ( ; first != last; ++first, ++out) {
+                *out = std::move(*first);
+                alloc_traits::destroy(alloc, first);
+            }
+        });
+    } else {
+        // запись в out может бросить: до конца перемещения все элементы должны оставаться живыми
+        for_each_chunk(pos, n, [&out](T* first, T* last) { out = std::move(first, last, out); });
+        destroy_range(pos, n);
+    }
+    return out;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::ensure_buckets(std::pair<size_t, size_t> pos, size_t n) {
+    // заводит бакеты под n слотов начиная с pos (слоты карты уже должны быть)
+    if (n == 0) return;
+    std::pair<size_t, size_t> last = pos_calc(pos, n - 1);
+    for (size_t b = pos.first; b <= last.first; ++b) {
+        if (arr[b] == nullptr) {
+            arr[b] = acquire_bucket();
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::relocate_range(std::pair<size_t, size_t> src, std::pair<size_t, size_t> dst, size_t n) {
+    // побайтный перенос n элементов из src в dst (диапазоны могут пересекаться) кусками,
+    // не пересекающими границ бакетов; объекты в src после этого считаются сырой памятью
+    size_t s = (src.first << bucket_shift) + src.second;
+    size_t d = (dst.first << bucket_shift) + dst.second;
+    if (n == 0 || s == d) return;
+
+    if (d < s) {
+        for (size_t done = 0; done < n; ) {
+            size_t si    = s + done;
+            size_t di    = d + done;
+            size_t chunk = std::min({n - done, bucket_size - (si & bucket_mask), bucket_size - (di & bucket_mask)});
+            std::memmove(static_cast<void*>(arr[di >> bucket_shift] + (di & bucket_mask)),
+                         static_cast<const void*>(arr[si >> bucket_shift] + (si & bucket_mask)), chunk * sizeof(T));
+            done += chunk;
+        }
+    } else {
+        for (size_t left = n; left > 0; ) {
+            size_t se    = s + left;
+            size_t de    = d + left;
+            size_t chunk = std::min({left, ((se - 1) & bucket_mask) + 1, ((de - 1) & bucket_mask) + 1});
+            std::memmove(static_cast<void*>(arr[(de - chunk) >> bucket_shift] + ((de - chunk) & bucket_mask)),
+                         static_cast<const void*>(arr[(se - chunk) >> bucket_shift] + ((se - chunk) & bucket_mask)), chunk * sizeof(T));
+            left -= chunk;
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::drop_front_raw(size_t n) {
+    // сдвигает begin_pos на n слотов без деструкторов (объекты уже разрушены или перенесены);
+    // бакеты, которые остались целиком перед begin_pos, освобождаются, как в pop_front
+    std::pair<size_t, size_t> new_begin = pos_calc(begin_pos, n);
+    for (size_t b = begin_pos.first; b < new_begin.first; ++b) {
+        if (arr[b] != nullptr) {
+            release_bucket(arr[b]);
+        }
+    }
+    begin_pos = new_begin;
+    sz       -= n;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::drop_back_raw(size_t n) {
+    // то же для конца: освобождаются бакеты, в которых не осталось занятых слотов, как в pop_back
+    std::pair<size_t, size_t> new_end = pos_calc(end_pos, size_t(0) - n);
+    size_t first = new_end.second == 0 ? new_end.first : new_end.first + 1;
+    size_t last  = std::min<size_t>(end_pos.first, bucket_count - 1);
+    for (size_t b = first; b <= last; ++b) {
+        if (arr[b] != nullptr) {
+            release_bucket(arr[b]);
+        }
+    }
+    end_pos = new_end;
+    sz     -= n;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::clear_raw() {
+    // clear() без деструкторов: элементы уже разрушены или их бакеты отданы другому деку
+    for (T*& bucket : arr) {
+        if (bucket != nullptr) {
+            release_bucket(bucket);
+        }
+    }
+    sz        = 0;
+    begin_pos = bucket_count == 0 ? std::make_pair<size_t, size_t>(0, 0) : std::make_pair(bucket_count / 2, bucket_size / 2);
+    end_pos   = begin_pos;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::relocate_n(T* src, size_t n, T* dst) {
+    // перенос n элементов в сырую память другого бакета; src после этого - сырая память
+    if constexpr (relocate_by_memmove) {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    } else {
+        uninitialized_copy_a(std::make_move_iterator(src), n, dst);
+        for (size_t i = 0; i < n; ++i) {
+            alloc_traits::destroy(alloc, src + i);
+        }
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::take_layout(Deque& other) {
+    // обмен картами и элементами с деком с равным аллокатором; пулы и лимиты остаются свои
+    using std::swap;
+    arr.swap(other.arr);
+    swap(bucket_count, other.bucket_count);
+    swap(sz, other.sz);
+    swap(cap, other.cap);
+    swap(begin_pos, other.begin_pos);
+    swap(end_pos, other.end_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::reserve_map(size_t front_elems, size_t back_elems) {
+    // гарантирует, что в карте хватит слотов под front_elems элементов перед begin_pos и back_elems после end_pos
+    // (плюс слот под сам новый end_pos); карта перестраивается не больше одного раза, бакеты при этом не выделяются
+    if (bucket_count == 0) {
+        init_map();
+    }
+    size_t begin_lin = (begin_pos.first << bucket_shift) + begin_pos.second;
+    size_t end_lin   = (end_pos.first << bucket_shift) + end_pos.second;
+    if (begin_lin >= front_elems && cap - end_lin > back_elems) return;
+
+    size_t first    = begin_pos.first;
+    size_t last     = std::min<size_t>(end_pos.first, bucket_count - 1);
+    size_t front_b  = front_elems > begin_pos.second 
+                    ? ((front_elems - begin_pos.second + bucket_mask) >> bucket_shift) : 0;
+    size_t end_rel  = end_lin - (first << bucket_shift);
+    size_t needed   = front_b + ((end_rel + back_elems) >> bucket_shift) + 1;
+
+    size_t new_bucket_count = needed <= bucket_count ? bucket_count : std::max(needed, bucket_count * 2);
+    size_t new_first        = front_b + (new_bucket_count - needed) / 2;
+
+    map_type new_arr(new_bucket_count, nullptr, arr.get_allocator());
+    for (size_t i = 0; i < bucket_count; ++i) {
+        // бакеты вне занятой части (запас после reserve()) сохраняют положение относительно нее, если влезают
+        ptrdiff_t j = static_cast<ptrdiff_t>(new_first + i) - static_cast<ptrdiff_t>(first);
+        if (i >= first && i <= last) {
+            new_arr[j] = arr[i];
+        } else if (arr[i] != nullptr) {
+            if (j >= 0 && static_cast<size_t>(j) < new_bucket_count) {
+                new_arr[j] = arr[i];
+            } else {
+                release_bucket(arr[i]);
+            }
+        }
+    }
+    arr.swap(new_arr);
+    begin_pos.first = new_first;
+    end_pos.first   = end_pos.first - first + new_first;
+    bucket_count    = new_bucket_count;
+    cap             = bucket_size * new_bucket_count;
+
+    if (back_elems > 0) {
+        Stats::on_expand_back((last - first + 1) * sizeof(T*));
+    } else {
+        Stats::on_expand_front((last - first + 1) * sizeof(T*));
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::adopt_layout(size_t buckets, size_t first_offset, size_t n) {
+    // карта из buckets пустых слотов и слота под end_pos, n элементов с first_offset в первом бакете;
+    // бакеты вставляет вызывающий
+    arr.assign(buckets + 1, nullptr);
+    bucket_count = buckets + 1;
+    cap          = bucket_size * bucket_count;
+    begin_pos    = {0, first_offset};
+    end_pos      = pos_calc(begin_pos, n);
+    sz           = n;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+bool Deque<T, BucketSize, Allocator, Stats>::recenter() {
+    // если занято не больше половины карты, сдвигаем занятые бакеты в её середину вместо удвоения
+    size_t used = end_pos.first - begin_pos.first + 1;
+    if (2 * used > bucket_count) return false;
+
+    size_t new_first = (bucket_count - used) / 2;
+    size_t old_first = begin_pos.first;
+    if (new_first == old_first) return false;
+
+    if (new_first < old_first) {
+        std::rotate(arr.begin(), arr.begin() + (old_first - new_first), arr.end());
+    } else {
+        std::rotate(arr.begin(), arr.end() - (new_first - old_first), arr.end());
+    }
+    begin_pos.first = new_first;
+    end_pos.first   = end_pos.first - old_first + new_first;
+    return true;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::expand_back(size_t n) {
+    if (bucket_count == 0) {
+        init_map();
+        Stats::on_expand_back(0);
+        return;
+    }
+    if (recenter()) {
+        Stats::on_expand_back(bucket_count * sizeof(T*));
+        return;
+    }
+    if (n < 2) return;
+    // новые слоты карты остаются пустыми: бакеты под них берутся лениво в emplace_back
+    Stats::on_expand_back(bucket_count * sizeof(T*));
+    size_t new_bucket_count = bucket_count * n;
+    arr.resize(new_bucket_count, nullptr);
+    cap              = bucket_size * new_bucket_count;
+    bucket_count     = new_bucket_count;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::expand_front(size_t n) {
+    if (bucket_count == 0) {
+        init_map();
+        if (begin_pos.second > 0) {
+            Stats::on_expand_front(0);
+            return;
+        }
+    }
+    if (recenter()) {
+        Stats::on_expand_front(bucket_count * sizeof(T*));
+        return;
+    }
+    if (n < 2) return;
+    Stats::on_expand_front(bucket_count * sizeof(T*));
+    size_t new_bucket_count = bucket_count * n;
+    map_type new_arr(new_bucket_count, nullptr, arr.get_allocator());
+    std::copy(arr.begin(), arr.end(), new_arr.begin() + (new_bucket_count - bucket_count));
+    arr.swap(new_arr);
+    cap              = bucket_size * new_bucket_count;
+    begin_pos.first += new_bucket_count - bucket_count;
+    end_pos.first   += new_bucket_count - bucket_count;
+    bucket_count     = new_bucket_count;
+}
+
+// Public functions ----------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque() : Deque(Allocator()) {}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(const Allocator& allocator) : alloc(allocator), arr(map_allocator(alloc)), bucket_count(0), sz(0), cap(0),
+                                                                       begin_pos{0, 0}, end_pos{0, 0},
+                                                                       spare(map_allocator(alloc)), spare_max(default_spare_limit) {
+    // пустой дек ничего не выделяет: карта и первый бакет появятся при первой вставке
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(const Deque& other) 
+    : Deque(other, alloc_traits::select_on_container_copy_construction(other.alloc)) {}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(const Deque& other, const Allocator& allocator) 
+    : alloc(allocator), arr(other.bucket_count, nullptr, map_allocator(alloc)), bucket_count(other.bucket_count),
+      sz(other.sz), cap(other.cap),
+      begin_pos(other.begin_pos), end_pos(other.end_pos),
+      spare(map_allocator(alloc)), spare_max(other.spare_max) {
+    copy_buckets(other, arr);
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(int n, const T& value, const Allocator& allocator) 
+    : alloc(allocator), arr(map_allocator(alloc)), sz(0), begin_pos{0, bucket_size / 2}, spare(map_allocator(alloc)), spare_max(default_spare_limit) {
+    if (n < 0) throw std::bad_alloc();
+
+    size_t first_indx = (bucket_size / 2);
+    size_t buckets    = ((n + first_indx) >> bucket_shift) + (((n + first_indx) & bucket_mask) == 0 ? 0 : 1);
+    size_t slots      = ((n + first_indx) >> bucket_shift) + 1;  // включая слот под end_pos
+
+    arr.resize(slots, nullptr);
+    cap          = slots * bucket_size;
+    bucket_count = slots;
+    end_pos      = begin_pos;
+
+    try {
+        for (size_t i = 0; i < buckets; ++i) {
+            arr[i] = allocate_bucket();
+        }
+        for ( ; sz < static_cast<size_t>(n); ++sz) {
+            alloc_traits::construct(alloc, arr[end_pos.first] + end_pos.second, value);  // вызываем копирующий конструктор
+            pos_forward(end_pos);
+        }
+    }
+    catch(...) {
+        destroy_all();
+        throw;
+    }
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(Deque&& other) noexcept : alloc(std::move(other.alloc)), arr(std::move(other.arr)), bucket_count(other.bucket_count), 
+                                             sz(other.sz), cap(other.cap), 
+                                             begin_pos(other.begin_pos), end_pos(other.end_pos),
+                                             spare(std::move(other.spare)), spare_max(other.spare_max) {
+    other.reset_empty();
+    other.spare.clear();
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(Deque&& other, const Allocator& allocator) 
+    : alloc(allocator), arr(map_allocator(alloc)), spare(map_allocator(alloc)), spare_max(other.spare_max) {
+    reset_empty();
+    if (alloc == other.alloc) {
+        swap(other);
+        return;
+    }
+    // память other принадлежит другому аллокатору: переносим поэлементно
+    try {
+        for (std::pair<size_t, size_t> pos = other.begin_pos; pos != other.end_pos; other.pos_forward(pos)) {
+            emplace_back(std::move(other.arr[pos.first][pos.second]));
+        }
+    }
+    catch (...) {
+        destroy_all();
+        free_spare();
+        throw;
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename InputIt, typename>
+Deque<T, BucketSize, Allocator, Stats>::Deque(InputIt first, InputIt last, const Allocator& allocator) : Deque(allocator) {
+    append_iter(first, last);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::Deque(std::initializer_list<T> init, const Allocator& allocator) : Deque(allocator) {
+    append_forward(init.begin(), init.size());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>::~Deque() {
+    destroy_all();
+    free_spare();
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>& Deque<T, BucketSize, Allocator, Stats>::operator=(const Deque& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (alloc_traits::propagate_on_container_copy_assignment::value && alloc != other.alloc) {
+        // старая память должна вернуться старому аллокатору до его замены
+        destroy_all();
+        free_spare();
+        reset_empty();
+        const map_type empty_map(map_allocator(other.alloc));
+        arr   = empty_map; // копирующее присваивание вектора переносит и аллокатор
+        spare = empty_map;
+    }
+    deque_detail::propagate_allocator(alloc, other.alloc, typename alloc_traits::propagate_on_container_copy_assignment());
+
+    map_type new_arr(other.bucket_count, nullptr, map_allocator(alloc));
+    copy_buckets(other, new_arr);
+
+    // если все прошло без исключений, освобождаем старые элементы и бакеты
+    destroy_all();
+
+    // копируем новый вектор
+    arr.swap(new_arr);
+
+    // копируем состояние
+    bucket_count = other.bucket_count;
+    begin_pos    = other.begin_pos;
+    end_pos      = other.end_pos;
+    sz           = other.sz;
+    cap          = other.cap;
+    Stats::on_size(sz, cap);
+
+    return *this;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats>& Deque<T, BucketSize, Allocator, Stats>::operator=(Deque&& other) 
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+
+    destroy_all();
+    free_spare();
+    reset_empty();
+
+    if (!alloc_traits::propagate_on_container_move_assignment::value && alloc != other.alloc) {
+        // аллокаторы не совпадают и не переносятся: перемещаем поэлементно
+        for (std::pair<size_t, size_t> pos = other.begin_pos; pos != other.end_pos; other.pos_forward(pos)) {
+            emplace_back(std::move(other.arr[pos.first][pos.second]));
+        }
+        return *this;
+    }
+
+    deque_detail::propagate_allocator(alloc, other.alloc, typename alloc_traits::propagate_on_container_move_assignment());
+    arr          = std::move(other.arr);
+    spare        = std::move(other.spare);
+    spare_max    = other.spare_max;
+    bucket_count = other.bucket_count;
+    sz           = other.sz;
+    cap          = other.cap;
+    begin_pos    = other.begin_pos;
+    end_pos      = other.end_pos;
+
+    other.reset_empty();
+    other.spare.clear();
+
+    return *this;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::swap(Deque& other) noexcept {
+    using std::swap;
+    deque_detail::propagate_allocator_swap(alloc, other.alloc, typename alloc_traits::propagate_on_container_swap());
+    arr.swap(other.arr);
+    spare.swap(other.spare);
+    swap(spare_max, other.spare_max);
+    swap(bucket_count, other.bucket_count);
+    swap(sz, other.sz);
+    swap(cap, other.cap);
+    swap(begin_pos, other.begin_pos);
+    swap(end_pos, other.end_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void swap(Deque<T, BucketSize, Allocator, Stats>& lhs, Deque<T, BucketSize, Allocator, Stats>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::allocator_type Deque<T, BucketSize, Allocator, Stats>::get_allocator() const {
+    return alloc;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::assign(size_t n, const T& value) {
+    clear();
+    reserve_map(0, n);
+    construct_at(end_pos, n, [&](T* dst, size_t count) { uninitialized_fill_a(dst, count, value); });
+    end_pos = pos_calc(end_pos, n);
+    sz      = n;
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename InputIt, typename>
+void Deque<T, BucketSize, Allocator, Stats>::assign(InputIt first, InputIt last) {
+    clear();
+    append_iter(first, last);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::assign(std::initializer_list<T> init) {
+    clear();
+    append_forward(init.begin(), init.size());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename Range>
+void Deque<T, BucketSize, Allocator, Stats>::assign_range(Range&& range) {
+    using std::begin;
+    using std::end;
+    clear();
+    append_iter(begin(range), end(range));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename Range>
+void Deque<T, BucketSize, Allocator, Stats>::append_range(Range&& range) {
+    using std::begin;
+    using std::end;
+    append_iter(begin(range), end(range));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename Range>
+void Deque<T, BucketSize, Allocator, Stats>::prepend_range(Range&& range) {
+    using std::begin;
+    using std::end;
+    prepend_iter(begin(range), end(range));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t Deque<T, BucketSize, Allocator, Stats>::spare_limit() const {
+    return spare_max;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::set_spare_limit(size_t n) {
+    spare_max = n;
+    while (spare.size() > spare_max) {
+        deallocate_bucket(spare.back());
+        spare.pop_back();
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::reserve(size_t n) {
+    if (n <= sz) return;
+    reserve_map(0, n - sz);
+    ensure_buckets(end_pos, n - sz);
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::reserve_front(size_t n) {
+    if (n <= sz) return;
+    reserve_map(n - sz, 0);
+    ensure_buckets(pos_calc(begin_pos, size_t(0) - (n - sz)), n - sz);
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::shrink_to_fit() {
+    // отдаем пул и бакеты вне занятой части, карта ужимается до занятых бакетов и слота под end_pos
+    free_spare();
+    if (sz == 0) {
+        for (T* bucket : arr) {
+            deallocate_bucket(bucket);
+        }
+        reset_empty();
+        arr.shrink_to_fit();
+        return;
+    }
+
+    size_t first = begin_pos.first;
+    size_t last  = ((end_pos.first << bucket_shift) + end_pos.second - 1) >> bucket_shift;
+    map_type new_arr(end_pos.first - first + 1, nullptr, arr.get_allocator());
+    for (size_t i = 0; i < bucket_count; ++i) {
+        if (i >= first && i <= last) {
+            new_arr[i - first] = arr[i];
+        } else {
+            deallocate_bucket(arr[i]);
+        }
+    }
+    arr.swap(new_arr);
+    bucket_count     = end_pos.first - first + 1;
+    cap              = bucket_size * bucket_count;
+    begin_pos.first -= first;
+    end_pos.first   -= first;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+const Stats& Deque<T, BucketSize, Allocator, Stats>::stats() const {
+    return *this;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Stats& Deque<T, BucketSize, Allocator, Stats>::stats() {
+    return *this;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+deque_memory_usage Deque<T, BucketSize, Allocator, Stats>::memory_usage() const {
+    size_t buckets = std::count_if(arr.begin(), arr.end(), [](const T* bucket) { return bucket != nullptr; });
+    deque_memory_usage usage;
+    usage.live_bytes   = sz * sizeof(T);
+    usage.bucket_bytes = buckets * bucket_size * sizeof(T);
+    usage.spare_bytes  = spare.size() * bucket_size * sizeof(T);
+    usage.map_bytes    = (arr.capacity() + spare.capacity()) * sizeof(T*);
+    return usage;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+deque_bucket_occupancy Deque<T, BucketSize, Allocator, Stats>::bucket_occupancy() const {
+    deque_bucket_occupancy occupancy;
+    occupancy.map_slots     = bucket_count;
+    occupancy.buckets       = std::count_if(arr.begin(), arr.end(), [](const T* bucket) { return bucket != nullptr; });
+    occupancy.spare_buckets = spare.size();
+    occupancy.bucket_size   = bucket_size;
+    occupancy.elements      = sz;
+    return occupancy;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::save(const std::string& path) const {
+    static_assert(std::is_trivially_copyable<T>::value, "save(): T must be trivially copyable");
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("save(): cannot open " + path);
+    }
+    auto write = [&](const void* data, size_t bytes) {
+        if (bytes > 0 && std::fwrite(data, 1, bytes, file.get()) != bytes) {
+            throw std::runtime_error("save(): cannot write " + path);
+        }
+    };
+
+    unsigned char head[deque_detail::file_data_offset] = {};
+    deque_detail::file_header header = deque_detail::make_file_header(sizeof(T), bucket_size, sz, sz == 0 ? 0 : begin_pos.second);
+    std::memcpy(head, &header, sizeof(header));
+    write(head, sizeof(head));
+
+    // свободные слоты крайних бакетов забиваем нулями, чтобы не писать неинициализированную память
+    std::vector<unsigned char> zeros;
+    bool first_segment = true;
+    for_each_segment([&](const T* first, const T* last) {
+        size_t lead = first_segment ? begin_pos.second : 0;
+        size_t tail = bucket_size - lead - (last - first);
+        if (lead + tail > 0 && zeros.empty()) {
+            zeros.resize(bucket_size * sizeof(T));
+        }
+        write(zeros.data(), lead * sizeof(T));
+        write(first, (last - first) * sizeof(T));
+        write(zeros.data(), tail * sizeof(T));
+        first_segment = false;
+    });
+    if (std::fclose(file.release()) != 0) {
+        throw std::runtime_error("save(): cannot write " + path);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats> Deque<T, BucketSize, Allocator, Stats>::load(const std::string& path, const Allocator& allocator) {
+    static_assert(std::is_trivially_copyable<T>::value, "load(): T must be trivially copyable");
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!file) {
+        throw std::runtime_error("load(): cannot open " + path);
+    }
+    deque_detail::file_header header;
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 || std::fseek(file.get(), deque_detail::file_data_offset, SEEK_SET) != 0) {
+        throw std::runtime_error("load(): " + path + " is not a Deque file");
+    }
+    // длину файла проверяют сами fread: короткое чтение - обрезанный файл
+    deque_detail::check_file_header(header, sizeof(T), bucket_size, UINT64_MAX, path);
+
+    Deque result(allocator);
+    result.adopt_layout(header.buckets, header.first_offset, header.size);
+    for (size_t b = 0; b < header.buckets; ++b) {
+        result.arr[b] = result.allocate_bucket();
+        if (std::fread(static_cast<void*>(result.arr[b]), sizeof(T), bucket_size, file.get()) != bucket_size) {
+            throw std::runtime_error("Deque: " + path + " is corrupted or truncated");
+        }
+    }
+    Stats& stats = result;
+    stats.on_size(result.sz, result.cap);
+    return result;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats> Deque<T, BucketSize, Allocator, Stats>::load_mapped(const std::string& path) {
+    static_assert(std::is_trivially_copyable<T>::value, "load_mapped(): T must be trivially copyable");
+    Allocator allocator = Allocator::map_file(path);
+    unsigned char* data = allocator.mapped_data();
+    size_t bytes        = allocator.mapped_size();
+
+    deque_detail::file_header header;
+    if (bytes < sizeof(header)) {
+        throw std::runtime_error("load_mapped(): " + path + " is not a Deque file");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    deque_detail::check_file_header(header, sizeof(T), bucket_size, bytes, path);
+
+    // аллокатор дека держит отображение, пока в нем остаются бакеты файла
+    Deque result(allocator);
+    result.adopt_layout(header.buckets, header.first_offset, header.size);
+    Stats& stats = result;
+    for (size_t b = 0; b < header.buckets; ++b) {
+        result.arr[b] = reinterpret_cast<T*>(data + deque_detail::file_data_offset + b * bucket_size * sizeof(T));
+        stats.on_bucket_allocate();
+    }
+    stats.on_size(result.sz, result.cap);
+    return result;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t Deque<T, BucketSize, Allocator, Stats>::size() const {
+    return sz;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t Deque<T, BucketSize, Allocator, Stats>::capacity() const {
+    return cap;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+bool Deque<T, BucketSize, Allocator, Stats>::empty() const {
+    return sz == 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::clear() {
+    destroy_elements();
+    clear_raw();
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T& Deque<T, BucketSize, Allocator, Stats>::operator[](size_t index) {
+    return const_cast<T&>(const_cast<const Deque<T, BucketSize, Allocator, Stats>*>(this)->operator[](index));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+const T& Deque<T, BucketSize, Allocator, Stats>::operator[](size_t index) const {
+    std::pair<size_t, size_t> pos = pos_calc(begin_pos, index);
+    return arr[pos.first][pos.second];
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+T& Deque<T, BucketSize, Allocator, Stats>::at(size_t index) {
+    return const_cast<T&>(const_cast<const Deque<T, BucketSize, Allocator, Stats>*>(this)->at(index));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+const T& Deque<T, BucketSize, Allocator, Stats>::at(size_t index) const {
+    std::pair<size_t, size_t> pos = pos_calc(begin_pos, index);
+    if (is_index_in_range(pos)) return arr[pos.first][pos.second];
+    else throw std::out_of_range("at(): out of range");
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::push_back(const T& value){
+    emplace_back(value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::pop_back() {
+    if (sz == 0) {
+        return;
+    } 
+    --sz;
+    pos_back(end_pos);
+    alloc_traits::destroy(alloc, arr[end_pos.first] + end_pos.second);
+    if (end_pos.second == 0) {
+        release_bucket(arr[end_pos.first]); // бакет опустел
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::push_front(const T& value) {
+    emplace_front(value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::push_front(T&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::pop_front() {
+    if (sz == 0) {
+        return;
+    } 
+    --sz;
+    alloc_traits::destroy(alloc, arr[begin_pos.first] + begin_pos.second);
+    pos_forward(begin_pos);
+    if (begin_pos.second == 0) {
+        release_bucket(arr[begin_pos.first - 1]); // бакет опустел
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t Deque<T, BucketSize, Allocator, Stats>::pop_front_n(size_t n) {
+    n = std::min(n, sz);
+    if (n == 0) {
+        return 0;
+    }
+    destroy_range(begin_pos, n);
+    drop_front_raw(n);
+    return n;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+size_t Deque<T, BucketSize, Allocator, Stats>::pop_back_n(size_t n) {
+    n = std::min(n, sz);
+    if (n == 0) {
+        return 0;
+    }
+    destroy_range(pos_calc(end_pos, size_t(0) - n), n);
+    drop_back_raw(n);
+    return n;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename OutputIt>
+OutputIt Deque<T, BucketSize, Allocator, Stats>::drain_front(OutputIt out, size_t n) {
+    n = std::min(n, sz);
+    if (n == 0) {
+        return out;
+    }
+    out = move_out(begin_pos, n, out);
+    drop_front_raw(n);
+    return out;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename OutputIt>
+OutputIt Deque<T, BucketSize, Allocator, Stats>::drain_back(OutputIt out, size_t n) {
+    n = std::min(n, sz);
+    if (n == 0) {
+        return out;
+    }
+    out = move_out(pos_calc(end_pos, size_t(0) - n), n, out);
+    drop_back_raw(n);
+    return out;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::insert(iterator iter, const T& value) {
+    return emplace(iter, value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::insert(iterator iter, T&& value) {
+    return emplace(iter, std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename InputIt, typename>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::insert(iterator iter, InputIt first, InputIt last) {
+    size_t index = iter - begin();
+    if constexpr (deque_detail::is_forward_iterator<InputIt>::value) {
+        insert_forward(index, first, static_cast<size_t>(std::distance(first, last)));
+    } else {
+        // однопроходный диапазон: сначала собираем его, чтобы узнать длину
+        Deque tmp(first, last, alloc);
+        insert_forward(index, std::make_move_iterator(tmp.begin()), tmp.size());
+    }
+    return begin() + index;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::insert(iterator iter, std::initializer_list<T> init) {
+    size_t index = iter - begin();
+    insert_forward(index, init.begin(), init.size());
+    return begin() + index;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename... Args>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::emplace(iterator iter, Args&&... args) {
+    size_t index = iter - begin();
+    if (index == 0) {
+        emplace_front(std::forward<Args>(args)...);
+        return begin();
+    }
+    if (index == sz) {
+        emplace_back(std::forward<Args>(args)...);
+        return end() - 1;
+    }
+
+    Stats::on_shift(std::min(index, sz - index));
+
+    if constexpr (relocate_by_memmove) {
+        // место под слот заводим до создания элемента: карта и бакеты не двигают сами элементы,
+        // так что ссылки в args остаются верными
+        bool front = index < sz - index;
+        if (front) {
+            reserve_map(1, 0);
+            ensure_buckets(pos_calc(begin_pos, size_t(0) - 1), 1);
+        } else {
+            reserve_map(0, 1);
+            ensure_buckets(end_pos, 1);
+        }
+        // элемент строится в сырой памяти и затем переносится в щель побайтно
+        alignas(T) unsigned char buffer[sizeof(T)];
+        alloc_traits::construct(alloc, reinterpret_cast<T*>(buffer), std::forward<Args>(args)...);
+        if (front) {
+            std::pair<size_t, size_t> new_begin = pos_calc(begin_pos, size_t(0) - 1);
+            relocate_range(begin_pos, new_begin, index);
+            begin_pos = new_begin;
+        } else {
+            std::pair<size_t, size_t> at = pos_calc(begin_pos, index);
+            relocate_range(at, pos_calc(at, 1), sz - index);
+            end_pos = pos_calc(end_pos, 1);
+        }
+        ++sz;
+        Stats::on_size(sz, cap);
+        std::memcpy(static_cast<void*>(&(*this)[index]), buffer, sizeof(T));
+        return begin() + index;
+    }
+
+    T value(std::forward<Args>(args)...); // args могут ссылаться на элементы самого дека
+    // сдвигаем ту половину, которая короче
+    if (index < sz - index) {
+        emplace_front(std::move(*begin()));
+        std::move(begin() + 2, begin() + index + 1, begin() + 1);
+    } else {
+        emplace_back(std::move(*(end() - 1)));
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+    }
+    iterator it = begin() + index;
+    *it = std::move(value);
+    return it;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename... Args>
+void Deque<T, BucketSize, Allocator, Stats>::emplace_back(Args&&... args) {
+    // слот карты под end_pos должен остаться и после вставки: на нем стоит итератор end()
+    if (bucket_count == 0) {
+        expand_back();
+    }
+    if (((end_pos.first << bucket_shift) + end_pos.second) + 1 == cap) {
+        expand_back();
+    }
+    if (arr[end_pos.first] == nullptr) {
+        arr[end_pos.first] = acquire_bucket();
+    }
+    alloc_traits::construct(alloc, arr[end_pos.first] + end_pos.second, std::forward<Args>(args)...);
+    ++sz;
+    pos_forward(end_pos);
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename... Args>
+void Deque<T, BucketSize, Allocator, Stats>::emplace_front(Args&&... args) {
+    if ((begin_pos.first == begin_pos.second) && (begin_pos.first == 0)) {
+        expand_front();
+    }
+    std::pair<size_t, size_t> pos = begin_pos;
+    pos_back(pos);
+    if (arr[pos.first] == nullptr) {
+        arr[pos.first] = acquire_bucket();
+    }
+    alloc_traits::construct(alloc, arr[pos.first] + pos.second, std::forward<Args>(args)...);
+    ++sz;
+    begin_pos = pos;
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::erase(iterator iter) {
+    return erase(iter, iter + 1);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::erase(iterator first, iterator last) {
+    size_t index = first - begin();
+    size_t n     = last - first;
+    if (n == 0) {
+        return first;
+    }
+    // каждый оставшийся элемент сдвигается один раз, со стороны, где элементов меньше
+    Stats::on_shift(std::min(index, sz - index - n));
+    if constexpr (relocate_by_memmove) {
+        // разрушаем удаляемые и закрываем щель memmove-ом короткой стороны
+        destroy_range(pos_calc(begin_pos, index), n);
+        if (index < sz - index - n) {
+            relocate_range(begin_pos, pos_calc(begin_pos, n), index);
+            drop_front_raw(n);
+        } else {
+            std::pair<size_t, size_t> at = pos_calc(begin_pos, index);
+            relocate_range(pos_calc(at, n), at, sz - index - n);
+            drop_back_raw(n);
+        }
+    } else if (index < sz - index - n) {
+        std::move_backward(begin(), first, last);
+        pop_front_n(n);
+    } else {
+        std::move(last, end(), first);
+        pop_back_n(n);
+    }
+    return begin() + index;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::splice_back(Deque&& other) {
+    size_t m = other.sz;
+    if (this == &other || m == 0) {
+        return;
+    }
+    if (alloc != other.alloc) {
+        // бакеты other нельзя отдать нашему аллокатору
+        append_forward(std::make_move_iterator(other.begin()), m);
+        other.clear();
+        return;
+    }
+    if (sz == 0) {
+        clear_raw();
+        take_layout(other);
+        Stats::on_size(sz, cap);
+        return;
+    }
+    if (end_pos.second != other.begin_pos.second) {
+        // стык попадает в разные позиции бакета: без сдвига всех элементов одной из сторон не склеить
+        if (m <= sz) {
+            append_forward(std::make_move_iterator(other.begin()), m);
+            other.clear();
+        } else {
+            other.prepend_forward(std::make_move_iterator(begin()), sz);
+            clear();
+            take_layout(other);
+            Stats::on_size(sz, cap);
+        }
+        return;
+    }
+
+    reserve_map(0, m);
+    size_t src  = other.begin_pos.first;
+    size_t last = ((other.end_pos.first << bucket_shift) + other.end_pos.second - 1) >> bucket_shift;
+    size_t dst  = end_pos.first;
+    if (end_pos.second > 0) {
+        // наш последний бакет занят до end_pos.second, первый бакет other - с той же позиции
+        size_t head = std::min(bucket_size - end_pos.second, m);
+        relocate_n(other.arr[src] + end_pos.second, head, arr[dst] + end_pos.second);
+        ++src;
+        ++dst;
+    }
+    for ( ; src <= last; ++src, ++dst) {
+        if (arr[dst] != nullptr) {
+            release_bucket(arr[dst]); // пустой бакет из запаса reserve()
+        }
+        arr[dst]       = other.arr[src];
+        other.arr[src] = nullptr;
+    }
+    end_pos = pos_calc(end_pos, m);
+    sz     += m;
+    other.clear_raw();
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::splice_front(Deque&& other) {
+    size_t m = other.sz;
+    if (this == &other || m == 0) {
+        return;
+    }
+    if (alloc != other.alloc) {
+        prepend_forward(std::make_move_iterator(other.begin()), m);
+        other.clear();
+        return;
+    }
+    if (sz == 0) {
+        clear_raw();
+        take_layout(other);
+        Stats::on_size(sz, cap);
+        return;
+    }
+    if (other.end_pos.second != begin_pos.second) {
+        if (m <= sz) {
+            prepend_forward(std::make_move_iterator(other.begin()), m);
+            other.clear();
+        } else {
+            other.append_forward(std::make_move_iterator(begin()), sz);
+            clear();
+            take_layout(other);
+            Stats::on_size(sz, cap);
+        }
+        return;
+    }
+
+    reserve_map(m, 0);
+    if (begin_pos.second > 0) {
+        // наш первый бакет занят с begin_pos.second, последний бакет other - до той же позиции
+        size_t head = std::min(begin_pos.second, m);
+        size_t at   = begin_pos.second - head;
+        relocate_n(other.arr[other.end_pos.first] + at, head, arr[begin_pos.first] + at);
+    }
+    // остальные бакеты other - целые, кроме, может быть, первого, который стыкуется с началом
+    size_t dst = begin_pos.first;
+    for (size_t src = other.end_pos.first; src > other.begin_pos.first; ) {
+        --src;
+        --dst;
+        if (arr[dst] != nullptr) {
+            release_bucket(arr[dst]); // пустой бакет из запаса reserve_front()
+        }
+        arr[dst]       = other.arr[src];
+        other.arr[src] = nullptr;
+    }
+    begin_pos = pos_calc(begin_pos, size_t(0) - m);
+    sz       += m;
+    other.clear_raw();
+    Stats::on_size(sz, cap);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+Deque<T, BucketSize, Allocator, Stats> Deque<T, BucketSize, Allocator, Stats>::split_at(size_t index) {
+    if (index > sz) {
+        throw std::out_of_range("split_at(): out of range");
+    }
+    Deque result(alloc);
+    result.spare_max = spare_max;
+    if (index == sz) {
+        return result;
+    }
+    if (index == 0) {
+        result.take_layout(*this);
+        Stats::on_size(sz, cap);
+        return result;
+    }
+
+    // хвост сохраняет позицию в бакете, поэтому бакеты после стыка переходят целиком
+    std::pair<size_t, size_t> at = pos_calc(begin_pos, index);
+    size_t tail = sz - index;
+    size_t last = ((end_pos.first << bucket_shift) + end_pos.second - 1) >> bucket_shift;
+    result.adopt_layout(last - at.first + 1, at.second, tail);
+    size_t src = at.first;
+    size_t dst = 0;
+    if (at.second > 0) {
+        size_t head = std::min(bucket_size - at.second, tail);
+        result.arr[0] = result.allocate_bucket();
+        try {
+            relocate_n(arr[src] + at.second, head, result.arr[0] + at.second);
+        }
+        catch (...) {
+            // элементы остались у нас, result отдает свой единственный бакет и становится пустым
+            result.deallocate_bucket(result.arr[0]);
+            result.reset_empty();
+            throw;
+        }
+        ++src;
+        ++dst;
+    }
+    for ( ; src <= last; ++src, ++dst) {
+        result.arr[dst] = arr[src];
+        arr[src]        = nullptr;
+    }
+    end_pos = at;
+    sz      = index;
+    Stats::on_size(sz, cap);
+    Stats& result_stats = result;
+    result_stats.on_size(result.sz, result.cap);
+    return result;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::begin() {
+    return make_iterator<iterator>(begin_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::iterator Deque<T, BucketSize, Allocator, Stats>::end() {
+    return make_iterator<iterator>(end_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_iterator Deque<T, BucketSize, Allocator, Stats>::begin() const {
+    return make_iterator<const_iterator>(begin_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_iterator Deque<T, BucketSize, Allocator, Stats>::end() const {
+    return make_iterator<const_iterator>(end_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_iterator Deque<T, BucketSize, Allocator, Stats>::cbegin() const {
+    return make_iterator<const_iterator>(begin_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_iterator Deque<T, BucketSize, Allocator, Stats>::cend() const {
+    return make_iterator<const_iterator>(end_pos);
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::reverse_iterator Deque<T, BucketSize, Allocator, Stats>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::reverse_iterator Deque<T, BucketSize, Allocator, Stats>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_reverse_iterator Deque<T, BucketSize, Allocator, Stats>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_reverse_iterator Deque<T, BucketSize, Allocator, Stats>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_reverse_iterator Deque<T, BucketSize, Allocator, Stats>::crbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+typename Deque<T, BucketSize, Allocator, Stats>::const_reverse_iterator Deque<T, BucketSize, Allocator, Stats>::crend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename F>
+void Deque<T, BucketSize, Allocator, Stats>::for_each_segment(F&& f) {
+    const_cast<const Deque<T, BucketSize, Allocator, Stats>*>(this)->for_each_segment([&f](const T* first, const T* last) {
+        return f(const_cast<T*>(first), const_cast<T*>(last));
+    });
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+template <typename F>
+void Deque<T, BucketSize, Allocator, Stats>::for_each_segment(F&& f) const {
+    if (sz == 0) return;
+    size_t last_lin  = (end_pos.first << bucket_shift) + end_pos.second - 1;
+    size_t last_b    = last_lin >> bucket_shift;
+    for (size_t b = begin_pos.first; b <= last_b; ++b) {
+        const T* first = arr[b] + (b == begin_pos.first ? begin_pos.second : 0);
+        const T* last  = arr[b] + (b == last_b ? (last_lin & bucket_mask) + 1 : bucket_size);
+        if constexpr (std::is_same<decltype(f(first, last)), bool>::value) {
+            if (!f(first, last)) return;
+        } else {
+            f(first, last);
+        }
+    }
+}
+
+
+#ifdef _DEBUG
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::print_arr() const {
+    for (size_t i = 0; i < bucket_count; ++i) {
+        if (arr[i] == nullptr) {
+            std::cout << "-" << std::endl; // бакет еще не выделен
+            continue;
+        }
+        for (size_t j = 0; j < bucket_size; ++j) {
+            std::cout << arr[i][j] << " ";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+template <typename T, size_t BucketSize, typename Allocator, typename Stats>
+void Deque<T, BucketSize, Allocator, Stats>::print_deque() const {
+    size_t count = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        for (size_t j = 0; j < bucket_size; ++j) {
+            if (is_index_in_range(i, j)) {
+                ++count;
+                std::cout << arr[i][j] << " ";
+            }
+        }
+    }
+    std::cout << "(" << count << " elements)" << std::endl << std::endl;
+}
+#endif /* _DEBUG */
+
+
+#if __has_include(<memory_resource>)
+namespace pmr {
+
+// аналог std::pmr::deque: Deque поверх std::pmr::polymorphic_allocator
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Stats = deque_no_stats>
+using Deque = ::Deque<T, BucketSize, std::pmr::polymorphic_allocator<T>, Stats>;
+
+} // namespace pmr
+#endif
+
+
 #endif /* DEQUE_H */
\ No newline at end of file
@@ -0,0 +1,404 @@
+#ifndef SMALL_DEQUE_H
+#define SMALL_DEQUE_H
+
+#include <new>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Дек с встроенным буфером на N элементов: пока элементов не больше N, они лежат
+// внутри объекта в кольцевом буфере и память не выделяется вовсе. При переполнении
+// элементы переезжают в обычный Deque и дальше все операции идут в него; когда он
+// опустеет, дек возвращается во встроенный буфер, а память Deque остается до
+// уничтожения (повторное переполнение ее переиспользует).
+//
+// Встроенные элементы создаются placement new, аллокатор нужен только для Deque.
+template <typename T, size_t N = 16, typename Allocator = std::allocator<T>>
+class SmallDeque {
+private:
+    static_assert(N > 0, "SmallDeque: inline capacity must be positive");
+
+    using heap_type = Deque<T, deque_detail::default_bucket_size<T>(), Allocator>;
+
+    alignas(T) unsigned char buffer[N * sizeof(T)];
+    size_t    head;   // индекс первого элемента в buffer
+    size_t    count;  // элементов в buffer
+    bool      on_heap;
+    heap_type heap;
+
+    T* raw_slot(size_t i);
+    T* slot(size_t i);
+    const T* slot(size_t i) const;
+    void destroy_inline();
+    void spill();
+    template <typename... Args>
+    void emplace_back_slow(Args&&... args);
+    template <typename... Args>
+    void emplace_front_slow(Args&&... args);
+
+    template <bool IsConst>
+    class common_iterator {
+    private:
+        using ConditionalOwner = std::conditional_t<IsConst, const SmallDeque, SmallDeque>;
+        using ConditionalRef   = std::conditional_t<IsConst, const T&, T&>;
+        using ConditionalPtr   = std::conditional_t<IsConst, const T*, T*>;
+
+        ConditionalOwner* owner;
+        size_t            index;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = T;
+        using pointer           = ConditionalPtr;
+        using reference         = ConditionalRef;
+
+        common_iterator(ConditionalOwner* owner, size_t index) : owner(owner), index(index) {}
+
+        ConditionalRef operator*() const { return (*owner)[index]; }
+        ConditionalPtr operator->() const { return &(*owner)[index]; }
+        ConditionalRef operator[](difference_type n) const { return (*owner)[index + n]; }
+
+        common_iterator& operator++() { ++index; return *this; }
+        common_iterator& operator--() { --index; return *this; }
+        common_iterator operator++(int) { common_iterator old = *this; ++index; return old; }
+        common_iterator operator--(int) { common_iterator old = *this; --index; return old; }
+
+        common_iterator& operator+=(difference_type n) { index += n; return *this; }
+        common_iterator& operator-=(difference_type n) { index -= n; return *this; }
+        common_iterator operator+(difference_type n) const { return common_iterator(owner, index + n); }
+        common_iterator operator-(difference_type n) const { return common_iterator(owner, index - n); }
+        difference_type operator-(const common_iterator& other) const { return difference_type(index) - difference_type(other.index); }
+
+        bool operator==(const common_iterator& other) const { return index == other.index; }
+        bool operator!=(const common_iterator& other) const { return index != other.index; }
+        bool operator<(const common_iterator& other) const { return index < other.index; }
+        bool operator<=(const common_iterator& other) const { return index <= other.index; }
+        bool operator>(const common_iterator& other) const { return index > other.index; }
+        bool operator>=(const common_iterator& other) const { return index >= other.index; }
+    };
+
+public:
+    using value_type      = T;
+    using allocator_type  = Allocator;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using iterator        = common_iterator<false>;
+    using const_iterator  = common_iterator<true>;
+
+    static constexpr size_t inline_capacity = N;
+
+    SmallDeque() : SmallDeque(Allocator()) {}
+    explicit SmallDeque(const Allocator& allocator);
+    SmallDeque(const SmallDeque& other);
+    SmallDeque(SmallDeque&& other) noexcept(std::is_nothrow_move_constructible<T>::value);
+    ~SmallDeque();
+
+    SmallDeque& operator=(const SmallDeque& other);
+    SmallDeque& operator=(SmallDeque&& other);
+
+    T& operator[](size_t index);
+    const T& operator[](size_t index) const;
+    T& at(size_t index);
+    const T& at(size_t index) const;
+
+    size_t size() const;
+    bool empty() const;
+    // true, пока элементы лежат во встроенном буфере
+    bool is_inline() const;
+    void clear();
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void push_front(const T& value);
+    void push_front(T&& value);
+
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+    template <typename... Args>
+    void emplace_front(Args&&... args);
+
+    void pop_back();
+    void pop_front();
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+// сырой слот под i-й элемент (объекта там еще нет)
+template <typename T, size_t N, typename Allocator>
+T* SmallDeque<T, N, Allocator>::raw_slot(size_t i) {
+    size_t pos = head + i;
+    return reinterpret_cast<T*>(buffer) + (pos < N ? pos : pos - N);
+}
+
+template <typename T, size_t N, typename Allocator>
+T* SmallDeque<T, N, Allocator>::slot(size_t i) {
+    return std::launder(raw_slot(i));
+}
+
+template <typename T, size_t N, typename Allocator>
+const T* SmallDeque<T, N, Allocator>::slot(size_t i) const {
+    size_t pos = head + i;
+    return std::launder(reinterpret_cast<const T*>(buffer) + (pos < N ? pos : pos - N));
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::destroy_inline() {
+    if (!std::is_trivially_destructible<T>::value) {
+        for (size_t i = 0; i < count; ++i) {
+            slot(i)->~T();
+        }
+    }
+    head  = 0;
+    count = 0;
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::spill() {
+    // буфер полон: переносим его в Deque с запасом еще на N элементов
+    heap.reserve(2 * N);
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            heap.emplace_back(std::move_if_noexcept(*slot(i)));
+        }
+    }
+    catch (...) {
+        heap.clear();
+        throw;
+    }
+    destroy_inline();
+    on_heap = true;
+}
+
+// Вставка при полном буфере или в Deque: вынесена, чтобы быстрый путь оставался коротким
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+void SmallDeque<T, N, Allocator>::emplace_back_slow(Args&&... args) {
+    if (!on_heap) {
+        // args могут ссылаться на элемент буфера, который spill() переместит
+        T value(std::forward<Args>(args)...);
+        spill();
+        heap.emplace_back(std::move(value));
+        return;
+    }
+    heap.emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+void SmallDeque<T, N, Allocator>::emplace_front_slow(Args&&... args) {
+    if (!on_heap) {
+        T value(std::forward<Args>(args)...);
+        spill();
+        heap.emplace_front(std::move(value));
+        return;
+    }
+    heap.emplace_front(std::forward<Args>(args)...);
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>::SmallDeque(const Allocator& allocator) : head(0), count(0), on_heap(false), heap(allocator) {}
+
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>::SmallDeque(const SmallDeque& other)
+    : head(0), count(0), on_heap(false), heap(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.heap.get_allocator())) {
+    *this = other;
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>::SmallDeque(SmallDeque&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    : head(0), count(0), on_heap(other.on_heap), heap(std::move(other.heap)) {
+    if (!on_heap) {
+        for ( ; count < other.count; ++count) {
+            ::new (static_cast<void*>(raw_slot(count))) T(std::move(*other.slot(count)));
+        }
+        other.destroy_inline();
+    }
+    other.on_heap = false;
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>::~SmallDeque() {
+    destroy_inline();
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>& SmallDeque<T, N, Allocator>::operator=(const SmallDeque& other) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    for (size_t i = 0; i < other.size(); ++i) {
+        emplace_back(other[i]);
+    }
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDeque<T, N, Allocator>& SmallDeque<T, N, Allocator>::operator=(SmallDeque&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if (other.on_heap) {
+        heap    = std::move(other.heap);
+        on_heap = true;
+        other.on_heap = false;
+    } else {
+        for (size_t i = 0; i < other.count; ++i) {
+            emplace_back(std::move(*other.slot(i)));
+        }
+        other.destroy_inline();
+    }
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+T& SmallDeque<T, N, Allocator>::operator[](size_t index) {
+    return on_heap ? heap[index] : *slot(index);
+}
+
+template <typename T, size_t N, typename Allocator>
+const T& SmallDeque<T, N, Allocator>::operator[](size_t index) const {
+    return on_heap ? heap[index] : *slot(index);
+}
+
+template <typename T, size_t N, typename Allocator>
+T& SmallDeque<T, N, Allocator>::at(size_t index) {
+    if (index >= size()) throw std::out_of_range("at(): out of range");
+    return (*this)[index];
+}
+
+template <typename T, size_t N, typename Allocator>
+const T& SmallDeque<T, N, Allocator>::at(size_t index) const {
+    if (index >= size()) throw std::out_of_range("at(): out of range");
+    return (*this)[index];
+}
+
+template <typename T, size_t N, typename Allocator>
+size_t SmallDeque<T, N, Allocator>::size() const {
+    return on_heap ? heap.size() : count;
+}
+
+template <typename T, size_t N, typename Allocator>
+bool SmallDeque<T, N, Allocator>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, size_t N, typename Allocator>
+bool SmallDeque<T, N, Allocator>::is_inline() const {
+    return !on_heap;
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::clear() {
+    if (on_heap) {
+        heap.clear();
+        on_heap = false;
+    } else {
+        destroy_inline();
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::push_front(const T& value) {
+    emplace_front(value);
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::push_front(T&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+void SmallDeque<T, N, Allocator>::emplace_back(Args&&... args) {
+    if (!on_heap && count < N) {
+        ::new (static_cast<void*>(raw_slot(count))) T(std::forward<Args>(args)...);
+        ++count;
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        // копия в локальную переменную не дает адресу аргумента уйти в вызов,
+        // и компилятор пишет поля прямо в слот буфера, а не через временный объект
+        T value(std::forward<Args>(args)...);
+        emplace_back_slow(std::move(value));
+    } else {
+        emplace_back_slow(std::forward<Args>(args)...);
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+void SmallDeque<T, N, Allocator>::emplace_front(Args&&... args) {
+    if (!on_heap && count < N) {
+        size_t new_head = head == 0 ? N - 1 : head - 1;
+        ::new (static_cast<void*>(reinterpret_cast<T*>(buffer) + new_head)) T(std::forward<Args>(args)...);
+        head = new_head;
+        ++count;
+        return;
+    }
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        T value(std::forward<Args>(args)...);
+        emplace_front_slow(std::move(value));
+    } else {
+        emplace_front_slow(std::forward<Args>(args)...);
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::pop_back() {
+    if (on_heap) {
+        heap.pop_back();
+        on_heap = !heap.empty();
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+    slot(count - 1)->~T();
+    --count;
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDeque<T, N, Allocator>::pop_front() {
+    if (on_heap) {
+        heap.pop_front();
+        on_heap = !heap.empty();
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+    slot(0)->~T();
+    head = head + 1 == N ? 0 : head + 1;
+    --count;
+}
+
+#endif /* SMALL_DEQUE_H */
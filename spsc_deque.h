@@ -0,0 +1,254 @@
+#ifndef SPSC_DEQUE_H
+#define SPSC_DEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <stddef.h>
+
+#include "my_deque.h"
+
+// Очередь для передачи элементов между ровно одним производителем (push_back)
+// и ровно одним потребителем (try_pop_front) без мьютекса.
+//
+// Раскладка та же, что у Deque: элементы лежат в бакетах, бакеты - в карте указателей.
+// Вместо begin_pos/end_pos - два монотонных счетчика head и tail; элемент с номером i
+// лежит в бакете i >> bucket_shift, слот i & bucket_mask. Карта - кольцо: бакет b
+// хранится в slots[b & map_mask].
+//
+// Протокол:
+//   - производитель пишет элемент (и, если нужно, новый бакет в карту), затем
+//     публикует tail.store(release); потребитель читает tail.load(acquire);
+//   - потребитель забирает элемент, затем head.store(release); производитель
+//     переиспользует слот карты/память бакета только после head.load(acquire);
+//   - при росте карты производитель копирует живые бакеты в новую карту и
+//     публикует ее через map.store(release) до следующего tail.store, так что
+//     потребитель всегда видит карту, в которой есть его бакет. Старые карты
+//     потребитель может еще читать, поэтому они освобождаются только в деструкторе
+//     (их суммарный размер не больше текущей карты).
+//
+// Обе операции не ждут друг друга. push_back обращается к аллокатору только при
+// переходе в новый бакет, и то если потребитель не вернул пустой бакет на переиспользование;
+// аллокатор вызывается из обоих потоков и должен быть потокобезопасным.
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>(), typename Allocator = std::allocator<T>>
+class SpscDeque {
+private:
+    static_assert(BucketSize > 0, "SpscDeque: bucket size must be positive");
+
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    static constexpr size_t initial_map_size = 8;
+    // разносим счетчики производителя и потребителя по разным кэш-линиям
+    static constexpr size_t cache_line = 64;
+
+    using alloc_traits  = std::allocator_traits<Allocator>;
+    using map_allocator = typename alloc_traits::template rebind_alloc<T*>;
+
+    static_assert(std::is_same<typename alloc_traits::value_type, T>::value, "SpscDeque: Allocator::value_type must be T");
+    static_assert(std::is_same<typename alloc_traits::pointer, T*>::value, "SpscDeque: fancy pointers are not supported");
+
+    struct ring_map {
+        std::vector<T*, map_allocator> slots;
+        size_t map_mask;
+
+        ring_map(size_t n, const Allocator& alloc) : slots(n, nullptr, map_allocator(alloc)), map_mask(n - 1) {}
+
+        T*& slot(size_t bucket) {
+            return slots[bucket & map_mask];
+        }
+    };
+
+    // поля потребителя
+    alignas(cache_line) std::atomic<size_t> head;
+    size_t cached_tail;  // последний увиденный tail, чтобы не читать чужую линию на каждом pop
+
+    // поля производителя
+    alignas(cache_line) std::atomic<size_t> tail;
+    size_t cached_head;
+    std::vector<std::unique_ptr<ring_map>> maps;  // текущая карта - последняя, остальные ждут деструктора
+
+    // общие поля
+    alignas(cache_line) std::atomic<ring_map*> current;
+    std::atomic<T*> recycled;  // пустой бакет, возвращенный потребителем
+    Allocator alloc;
+
+    T* acquire_bucket();
+    void release_bucket(T* bucket);
+    void grow_map(size_t tail_bucket);
+    T* prepare_slot();
+
+public:
+    using value_type     = T;
+    using allocator_type = Allocator;
+    using size_type      = size_t;
+
+    SpscDeque() : SpscDeque(Allocator()) {}
+    explicit SpscDeque(const Allocator& alloc);
+    SpscDeque(const SpscDeque&) = delete;
+    SpscDeque& operator=(const SpscDeque&) = delete;
+    ~SpscDeque();
+
+    // Только поток-производитель
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <typename... Args>
+    void emplace_back(Args&&... args);
+
+    // Только поток-потребитель; false, если очередь пуста
+    bool try_pop_front(T& out);
+
+    // Приблизительные значения, если их смотрит третий поток
+    size_t size_approx() const;
+    bool empty_approx() const;
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+T* SpscDeque<T, BucketSize, Allocator>::acquire_bucket() {
+    T* bucket = recycled.exchange(nullptr, std::memory_order_acquire);
+    return bucket ? bucket : alloc_traits::allocate(alloc, bucket_size);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void SpscDeque<T, BucketSize, Allocator>::release_bucket(T* bucket) {
+    // заполняет recycled только потребитель, так что пустой слот никто не займет между load и store
+    if (recycled.load(std::memory_order_relaxed) == nullptr) {
+        recycled.store(bucket, std::memory_order_release);
+    } else {
+        alloc_traits::deallocate(alloc, bucket, bucket_size);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void SpscDeque<T, BucketSize, Allocator>::grow_map(size_t tail_bucket) {
+    ring_map* old_map = maps.back().get();
+    auto fresh = std::make_unique<ring_map>(old_map->slots.size() * 2, alloc);
+
+    // живые бакеты - от бакета head до текущего; бакеты ниже head потребитель уже не читает
+    for (size_t b = cached_head >> bucket_shift; b < tail_bucket; ++b) {
+        fresh->slot(b) = old_map->slot(b);
+    }
+    current.store(fresh.get(), std::memory_order_release);
+    maps.push_back(std::move(fresh));
+}
+
+// Возвращает адрес под элемент с номером tail, при необходимости заводя новый бакет
+template <typename T, size_t BucketSize, typename Allocator>
+T* SpscDeque<T, BucketSize, Allocator>::prepare_slot() {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t b = t >> bucket_shift;
+
+    if ((t & bucket_mask) == 0) {
+        ring_map* m = maps.back().get();
+        // слот карты b & map_mask свободен, если потребитель ушел из бакета b - map_size
+        if (b - (cached_head >> bucket_shift) >= m->slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (b - (cached_head >> bucket_shift) >= m->slots.size()) {
+                grow_map(b);
+                m = maps.back().get();
+            }
+        }
+        m->slot(b) = acquire_bucket();
+    }
+    return maps.back()->slot(b) + (t & bucket_mask);
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize, typename Allocator>
+SpscDeque<T, BucketSize, Allocator>::SpscDeque(const Allocator& alloc)
+    : head(0), cached_tail(0), tail(0), cached_head(0), current(nullptr), recycled(nullptr), alloc(alloc) {
+    maps.push_back(std::make_unique<ring_map>(initial_map_size, alloc));
+    current.store(maps.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+SpscDeque<T, BucketSize, Allocator>::~SpscDeque() {
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_relaxed);
+    ring_map* m = maps.back().get();
+
+    for (size_t i = h; i != t; ++i) {
+        alloc_traits::destroy(alloc, m->slot(i >> bucket_shift) + (i & bucket_mask));
+    }
+    // бакет tail заведен, даже если в нем еще нет элементов, кроме случая t на границе бакета
+    size_t last = (t + bucket_mask) >> bucket_shift;
+    for (size_t b = h >> bucket_shift; b < last; ++b) {
+        alloc_traits::deallocate(alloc, m->slot(b), bucket_size);
+    }
+    if (T* bucket = recycled.load(std::memory_order_relaxed)) {
+        alloc_traits::deallocate(alloc, bucket, bucket_size);
+    }
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void SpscDeque<T, BucketSize, Allocator>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+void SpscDeque<T, BucketSize, Allocator>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+template <typename... Args>
+void SpscDeque<T, BucketSize, Allocator>::emplace_back(Args&&... args) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    T* ptr = prepare_slot();
+    try {
+        alloc_traits::construct(alloc, ptr, std::forward<Args>(args)...);
+    } catch (...) {
+        // бакет, заведенный под этот элемент, потребитель не увидит - возвращаем его сразу
+        if ((t & bucket_mask) == 0) {
+            alloc_traits::deallocate(alloc, ptr, bucket_size);
+        }
+        throw;
+    }
+    tail.store(t + 1, std::memory_order_release);
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool SpscDeque<T, BucketSize, Allocator>::try_pop_front(T& out) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h == cached_tail) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (h == cached_tail) {
+            return false;
+        }
+    }
+
+    T* bucket = current.load(std::memory_order_acquire)->slot(h >> bucket_shift);
+    T* ptr = bucket + (h & bucket_mask);
+    out = std::move(*ptr);
+    alloc_traits::destroy(alloc, ptr);
+
+    // последний слот бакета: производитель уже в следующем бакете и этот больше не тронет
+    if (((h + 1) & bucket_mask) == 0) {
+        release_bucket(bucket);
+    }
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+size_t SpscDeque<T, BucketSize, Allocator>::size_approx() const {
+    size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_acquire);
+    return t >= h ? t - h : 0;
+}
+
+template <typename T, size_t BucketSize, typename Allocator>
+bool SpscDeque<T, BucketSize, Allocator>::empty_approx() const {
+    return size_approx() == 0;
+}
+
+#endif /* SPSC_DEQUE_H */
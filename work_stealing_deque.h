@@ -0,0 +1,195 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "my_deque.h"
+
+// Дек Чейза-Лева для планировщиков задач: поток-владелец кладет и забирает
+// задачи снизу (push_back/pop_back), остальные потоки крадут сверху (steal).
+// Владелец работает без CAS, кроме борьбы за последний элемент; вор делает один CAS по top.
+//
+// Хранилище - кольцо бакетов, как карта в Deque: элемент i лежит в бакете
+// (i >> bucket_shift) & map_mask, слот i & bucket_mask. Когда живые элементы
+// занимают все бакеты карты, владелец строит карту вдвое больше, как expand_back(),
+// переносит в нее указатели на те же бакеты (элементы не копируются) и добавляет новые.
+// Воры, прочитавшие старую карту, продолжают работать с ней: бакеты общие, а
+// переиспользованный слот дает устаревшее значение, которое отсечет неудачный CAS.
+// Поэтому старые карты и все бакеты освобождаются только в деструкторе.
+//
+// Элементы хранятся как std::atomic<T>, поэтому T должен быть тривиально копируемым
+// (обычно это Task* или индекс задачи).
+template <typename T, size_t BucketSize = deque_detail::default_bucket_size<T>()>
+class WorkStealingDeque {
+private:
+    static_assert(BucketSize > 0, "WorkStealingDeque: bucket size must be positive");
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque: T must be trivially copyable");
+
+    static constexpr size_t bucket_size  = deque_detail::round_up_pow2(BucketSize);
+    static constexpr size_t bucket_shift = deque_detail::log2_pow2(bucket_size);
+    static constexpr size_t bucket_mask  = bucket_size - 1;
+
+    static constexpr size_t initial_map_size = 4;
+    static constexpr size_t cache_line = 64;
+
+    using slot_type = std::atomic<T>;
+
+    struct ring_map {
+        std::vector<slot_type*> slots;
+        size_t map_mask;
+
+        explicit ring_map(size_t n) : slots(n, nullptr), map_mask(n - 1) {}
+
+        slot_type& at(int64_t i) const {
+            return slots[(size_t(i) >> bucket_shift) & map_mask][size_t(i) & bucket_mask];
+        }
+    };
+
+    alignas(cache_line) std::atomic<int64_t> top;     // сюда ходят воры
+    alignas(cache_line) std::atomic<int64_t> bottom;  // пишет только владелец
+    std::atomic<ring_map*> current;
+
+    // поля владельца
+    std::vector<std::unique_ptr<ring_map>> maps;     // текущая карта - последняя
+    std::vector<std::unique_ptr<slot_type[]>> buckets;
+
+    slot_type* new_bucket();
+    ring_map* grow(ring_map* old_map, int64_t t);
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    WorkStealingDeque();
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Только поток-владелец
+    void push_back(T value);
+    bool pop_back(T& out);
+
+    // Любой поток; false, если дек пуст или элемент увел другой поток
+    bool steal(T& out);
+
+    // Приблизительные значения, если их смотрит не владелец
+    size_t size_approx() const;
+    bool empty_approx() const;
+};
+
+
+// Private functions ---------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize>
+typename WorkStealingDeque<T, BucketSize>::slot_type* WorkStealingDeque<T, BucketSize>::new_bucket() {
+    buckets.emplace_back(new slot_type[bucket_size]);
+    return buckets.back().get();
+}
+
+// Вызывается, когда бакет для b совпал бы с бакетом top: переносим бакеты
+// [t >> shift, t >> shift + old_size) на их места в новой карте, остальные слоты - новые бакеты
+template <typename T, size_t BucketSize>
+typename WorkStealingDeque<T, BucketSize>::ring_map* WorkStealingDeque<T, BucketSize>::grow(ring_map* old_map, int64_t t) {
+    size_t old_size = old_map->slots.size();
+    auto fresh = std::make_unique<ring_map>(old_size * 2);
+
+    size_t first = size_t(t) >> bucket_shift;
+    for (size_t k = first; k < first + old_size; ++k) {
+        fresh->slots[k & fresh->map_mask] = old_map->slots[k & old_map->map_mask];
+    }
+    for (size_t k = first + old_size; k < first + 2 * old_size; ++k) {
+        fresh->slots[k & fresh->map_mask] = new_bucket();
+    }
+
+    ring_map* result = fresh.get();
+    current.store(result, std::memory_order_release);
+    maps.push_back(std::move(fresh));
+    return result;
+}
+
+
+// Public functions ----------------------------------------------------------------------------------/
+template <typename T, size_t BucketSize>
+WorkStealingDeque<T, BucketSize>::WorkStealingDeque() : top(0), bottom(0), current(nullptr) {
+    auto first = std::make_unique<ring_map>(initial_map_size);
+    for (size_t k = 0; k < initial_map_size; ++k) {
+        first->slots[k] = new_bucket();
+    }
+    current.store(first.get(), std::memory_order_relaxed);
+    maps.push_back(std::move(first));
+}
+
+template <typename T, size_t BucketSize>
+void WorkStealingDeque<T, BucketSize>::push_back(T value) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    ring_map* m = current.load(std::memory_order_relaxed);
+
+    // живые бакеты должны лежать в разных слотах карты, иначе при росте пришлось бы копировать элементы
+    if ((size_t(b) >> bucket_shift) - (size_t(t) >> bucket_shift) >= m->slots.size()) {
+        m = grow(m, t);
+    }
+    m->at(b).store(value, std::memory_order_relaxed);
+    // release-запись вместо отдельного барьера: то же на x86/ARM, и ее видит ThreadSanitizer
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+template <typename T, size_t BucketSize>
+bool WorkStealingDeque<T, BucketSize>::pop_back(T& out) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    ring_map* m = current.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    T value = m->at(b).load(std::memory_order_relaxed);
+    if (t == b) {
+        // последний элемент: соревнуемся с ворами за top
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        if (!won) {
+            return false;
+        }
+    }
+    out = value;
+    return true;
+}
+
+template <typename T, size_t BucketSize>
+bool WorkStealingDeque<T, BucketSize>::steal(T& out) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return false;
+    }
+    ring_map* m = current.load(std::memory_order_acquire);
+    T value = m->at(t).load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+template <typename T, size_t BucketSize>
+size_t WorkStealingDeque<T, BucketSize>::size_approx() const {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? size_t(b - t) : 0;
+}
+
+template <typename T, size_t BucketSize>
+bool WorkStealingDeque<T, BucketSize>::empty_approx() const {
+    return size_approx() == 0;
+}
+
+#endif /* WORK_STEALING_DEQUE_H */